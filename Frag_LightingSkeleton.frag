@@ -11,7 +11,12 @@ out vec4 fs_out_col;
 // textúra mintavételező objektum
 uniform sampler2D texImage;
 
-uniform vec3 cameraPos;
+// képkockánként egyszer feltöltött adatok, a vertex shaderrel közös blokk
+layout( std140, binding = 0 ) uniform FrameData
+{
+	mat4 viewProj;
+	vec4 cameraPos;
+};
 
 void main()
 {
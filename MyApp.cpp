@@ -1,9 +1,18 @@
 #include "MyApp.h"
 #include "SDL_GLDebugMessageCallback.h"
 #include "ParametricSurfaceMesh.hpp"
+#include "ParametricSurfaces.hpp"
 #include "ObjParser.h"
+#include "MeshOptimizer.hpp"
+#include "MeshPacking.hpp"
+#include "PoissonDisk.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
 #include <iostream>
 #include <sstream>
+#include <cstring>
 
 #include <imgui.h>
 
@@ -15,69 +24,6 @@ CMyApp::~CMyApp()
 {
 }
 
-// tórusz kirajzolásához szükséges adatok
-struct Torus
-{
-	float a, b;
-	Torus(float _a = 1.0f, float _b = 2.0f) : a(_a), b(_b) { }
-
-	glm::vec3 GetPos(float u, float v) const noexcept
-	{
-		u *= glm::two_pi<float>();
-		v *= -glm::two_pi<float>();
-		return glm::vec3(
-			(a * cosf(v) + b) * cosf(u),
-			 a * sinf(v),
-			(a * cosf(v) + b) * sinf(u)
-		);
-	}
-	glm::vec3 GetNorm(float u, float v) const noexcept
-	{
-		glm::vec3 du = GetPos(u + 0.01f, v) - GetPos(u - 0.01f, v);
-		glm::vec3 dv = GetPos(u, v + 0.01f) - GetPos(u, v - 0.01f);
-
-		return glm::normalize(glm::cross(du, dv));
-	}
-	glm::vec2 GetTex(float u, float v) const noexcept
-	{
-		return glm::vec2(u, v);
-	}
-};
-
-// gömb parametrikus egyenlete
-struct Sphere
-{
-	float r;
-	Sphere(float _r = 1.f) : r(_r) { }
-
-	glm::vec3 GetPos(float u, float v) const noexcept
-	{
-		u *= glm::two_pi<float>();
-		v *= glm::pi<float>();
-
-		return glm::vec3(
-			r * sinf(v) * cosf(u),
-			r * cosf(v),
-			r * sinf(v) * sinf(u)
-		);
-	}
-	glm::vec3 GetNorm(float u, float v) const noexcept
-	{
-		u *= glm::two_pi<float>();
-		v *= glm::pi<float>();
-
-		return glm::vec3(
-			sinf(v) * cosf(u),
-			cosf(v),
-			sinf(v) * sinf(u)
-		);
-	}
-	glm::vec2 GetTex(float u, float v) const noexcept
-	{
-		return glm::vec2(u, v);
-	}
-};
-
 void CMyApp::SetupDebugCallback()
 {
 	// engedélyezzük és állítsuk be a debug callback függvényt ha debug context-ben vagyunk 
@@ -94,65 +40,343 @@ void CMyApp::SetupDebugCallback()
 void CMyApp::InitShaders()
 {
 	m_programID = glCreateProgram();
-	AssembleProgram( m_programID, "Vert_PosNormTex.vert", "Frag_LightingSkeleton.frag" );
+	m_programUniforms = AssembleProgram( m_programID, "Vert_PosNormTex.vert", "Frag_LightingSkeleton.frag" );
+
+	m_uniforms.texImage = m_programUniforms.Get<GLint>( "texImage" );
+
+	m_paramSurfaceProgramID = glCreateProgram();
+	m_paramSurfaceProgramUniforms = AssembleProgram( m_paramSurfaceProgramID, "Vert_ParamSurface.vert", "Frag_LightingSkeleton.frag" );
+
+	m_paramSurfaceUniforms.texImage    = m_paramSurfaceProgramUniforms.Get<GLint>( "texImage" );
+	m_paramSurfaceUniforms.objectIndex = m_paramSurfaceProgramUniforms.Get<GLuint>( "objectIndex" );
+	m_paramSurfaceUniforms.resolutionN = m_paramSurfaceProgramUniforms.Get<GLuint>( "resolutionN" );
+	m_paramSurfaceUniforms.resolutionM = m_paramSurfaceProgramUniforms.Get<GLuint>( "resolutionM" );
+	m_paramSurfaceUniforms.torusA      = m_paramSurfaceProgramUniforms.Get<GLfloat>( "torusA" );
+	m_paramSurfaceUniforms.torusB      = m_paramSurfaceProgramUniforms.Get<GLfloat>( "torusB" );
+
+	// A rajzolások között nem változó uniformok egyszer, a linkelés után: a program megőrzi az értéküket,
+	// így a rajzolási sorban (RenderQueue) nem kell minden képkockában újra beállítani őket
+	const Torus torus;
+	glUseProgram( m_programID );
+	SetUniform( m_uniforms.texImage, 0 );
+	glUseProgram( m_paramSurfaceProgramID );
+	SetUniform( m_paramSurfaceUniforms.texImage, 0 );
+	SetUniform( m_paramSurfaceUniforms.objectIndex, static_cast<GLuint>( PARAM_SURFACE_SLOT ) );
+	SetUniform( m_paramSurfaceUniforms.torusA, torus.a );
+	SetUniform( m_paramSurfaceUniforms.torusB, torus.b );
+	glUseProgram( 0 );
+	UploadParamSurfaceResolution();
+
+	m_cullProgramID = glCreateProgram();
+	m_cullProgramUniforms = AssembleComputeProgram( m_cullProgramID, "Comp_CullSpheres.comp" );
+
+	m_cullUniforms.frustumPlanes  = m_cullProgramUniforms.Get<glm::vec4>( "frustumPlanes" );
+	m_cullUniforms.firstObject    = m_cullProgramUniforms.Get<GLuint>( "firstObject" );
+	m_cullUniforms.objectCount    = m_cullProgramUniforms.Get<GLuint>( "objectCount" );
+	m_cullUniforms.boundingRadius = m_cullProgramUniforms.Get<GLfloat>( "boundingRadius" );
+	m_cullUniforms.lodCapacity    = m_cullProgramUniforms.Get<GLuint>( "lodCapacity" );
+	m_cullUniforms.lodErrors      = m_cullProgramUniforms.Get<GLfloat>( "lodErrors" );
+	m_cullUniforms.lodPixelScale  = m_cullProgramUniforms.Get<GLfloat>( "lodPixelScale" );
+	m_cullUniforms.lodMaxPixelError = m_cullProgramUniforms.Get<GLfloat>( "lodMaxPixelError" );
 }
 
 void CMyApp::CleanShaders()
 {
 	glDeleteProgram( m_programID );
+
+	glDeleteProgram( m_paramSurfaceProgramID );
+
+	glDeleteProgram( m_cullProgramID );
+
+	// a helyek az újralinkelt programban mások lehetnek
+	m_programUniforms.Clear();
+	m_uniforms = {};
+	m_paramSurfaceProgramUniforms.Clear();
+	m_paramSurfaceUniforms = {};
+	m_cullProgramUniforms.Clear();
+	m_cullUniforms = {};
 }
 
 void CMyApp::InitGeometry()
 {
-	// Suzanne betöltése
-	MeshObject<Vertex> suzanneMeshCPU = ObjParser::parse("Assets/Suzanne.obj");
-	m_SuzanneGPU = CreateGLObjectFromMesh( suzanneMeshCPU, vertexAttribList );
+	// Suzanne betöltése: a bináris cache-ből (Assets/Suzanne.obj.meshcache), ha az naprakész,
+	// különben az OBJ-ből, amiből egyúttal a (vertex cache-re optimalizált) cache is elkészül a következő indításhoz
+	ObjParser::CachedMesh suzanneMeshCPU = ObjParser::parseCached("Assets/Suzanne.obj", true);
+
+	// Minden háló tömörített csúcsokkal a közös arénába kerül; a kezdő méret a jelenlegi színtérnek elég, szükség esetén nő.
+	// Az index típus a betöltött modellhez elég legkeskenyebb (a generált hálók 0xffff csúcs alattiak); ha később
+	// nagyobb háló jön (pl. a fánk nagyobb felbontással), az aréna 32 bites indexekre vált.
+	m_geometryArena.Init( vertexPackedAttribList, sizeof( VertexPacked ), IndexType( suzanneMeshCPU.View().vertexCount ), 1 << 15, 1 << 17 );
+
+	m_suzanneRange = m_geometryArena.Add( PackMesh( suzanneMeshCPU.View() ) );
+
+	const glm::mat4 suzanneWorld = glm::translate( SUZANNE_POS );
+	SetObjectTransform( SUZANNE_SLOT, suzanneWorld * m_suzanneRange.quantization.Matrix(), glm::transpose( glm::inverse( suzanneWorld ) ) );
+	SetObjectBounds( SUZANNE_SLOT, SUZANNE_POS + m_suzanneRange.quantization.offset, glm::length( m_suzanneRange.quantization.scale ) );
 
 	InitParametricSurfaceGeometry();
 	InitParametricSphereGeometry();
+
+	// az aréna VAO-jának objektum indexei: az i. parancs j. példánya a baseInstance + j. elemet kapja
+	glGenBuffers( 1, &m_visibleObjectsBufferID );
+	m_visibleSpheresCapacity = 0;
+	ReserveVisibleObjects( 0 );
+	BindObjectIndexAttribute( m_geometryArena.VaoID(), m_visibleObjectsBufferID );
+
+	glGenBuffers( 1, &m_drawCommandBufferID );
+	glBindBuffer( GL_DRAW_INDIRECT_BUFFER, m_drawCommandBufferID );
+	glBufferData( GL_DRAW_INDIRECT_BUFFER, DRAW_COMMAND_COUNT * sizeof( DrawElementsIndirectCommand ), nullptr, GL_DYNAMIC_DRAW );
+	glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+	WriteDrawCommands( nullptr );
 }
 
 void CMyApp::InitParametricSurfaceGeometry() {
-	// Patametrikus felület
-	MeshObject<Vertex> surfaceMeshCPU = GetParamSurfMesh(Torus(), m_resolutionN, m_resolutionM);
-	m_ParamSurfaceGPU = CreateGLObjectFromMesh(surfaceMeshCPU, vertexAttribList);
+	const glm::vec3 surfacePos = glm::vec3(0.0, -3.0, 0.0);
+	const glm::mat4 matWorld = glm::translate(surfacePos);
+
+	if (m_paramSurfaceOnGPU) {
+		// a csúcsokat a Vert_ParamSurface.vert számolja a gl_VertexID-ből, így nincs mit feltölteni
+		glGenVertexArrays(1, &m_emptyVaoID);
+
+		// nincs kvantálás: a shader a Torus egyenletét értékeli ki
+		const Torus torus;
+		SetObjectTransform(PARAM_SURFACE_SLOT, matWorld, glm::transpose(glm::inverse(matWorld)));
+		SetObjectBounds(PARAM_SURFACE_SLOT, surfacePos, torus.a + torus.b);
+		return;
+	}
+
+	// Patametrikus felület: a csúszka húzásakor a CPU-s tömbök és az arénabeli hely is újrahasznosítva (ha a háló nem nő).
+	// Soronként egy háromszögsáv (harmannyi index, mint listával); a sorok sorrendje már jó a vertex cache-nek.
+	GetParamSurfMesh(Torus(), m_paramSurfaceMeshCPU, m_resolutionN, m_resolutionM, MeshTopology::TriangleStrip);
+	PackMesh(m_paramSurfaceMeshCPU, m_paramSurfacePackedCPU);
+	m_geometryArena.Update(m_paramSurfaceRange, m_paramSurfacePackedCPU);
+
+	// a felbontás változásával a kvantálás (befoglaló doboz) is változhat, ezért itt frissítjük
+	SetObjectTransform(PARAM_SURFACE_SLOT, matWorld * m_paramSurfaceRange.quantization.Matrix(), glm::transpose(glm::inverse(matWorld)));
+	SetObjectBounds(PARAM_SURFACE_SLOT, surfacePos + m_paramSurfaceRange.quantization.offset, glm::length(m_paramSurfaceRange.quantization.scale));
 }
 
 void CMyApp::InitParametricSphereGeometry() {
-	MeshObject<Vertex> sphereMeshCPU = GetParamSurfMesh(Sphere(m_sphereRadius));
-	m_ParamSphereGPU = CreateGLObjectFromMesh(sphereMeshCPU, vertexAttribList);
+	// LOD-onként a felbontás (hosszúsági x szélességi felosztás), a GetParamSurfMesh alapértelmezett 80x40-éből felezve
+	static constexpr std::size_t LOD_RESOLUTIONS[SPHERE_LOD_COUNT][2] = { { 80, 40 }, { 40, 20 }, { 20, 10 }, { 10, 5 } };
+
+	// a szintek egymás után egy mesh-ben: az indexek szintenként 0-tól számoznak, a parancs baseVertex-e tolja el őket
+	MeshObject<Vertex> sphereMeshCPU;
+	for (int lod = 0; lod < SPHERE_LOD_COUNT; ++lod) {
+		const std::size_t N = LOD_RESOLUTIONS[lod][0];
+		const std::size_t M = LOD_RESOLUTIONS[lod][1];
+		MeshObject<Vertex> lodMeshCPU = GetParamSurfMesh(Sphere(m_sphereRadius), N, M);
+		OptimizeMesh(lodMeshCPU);
+
+		SphereLod& level = m_sphereLods[lod];
+		level.count = static_cast<GLuint>(lodMeshCPU.indexArray.size());
+		level.firstIndex = static_cast<GLuint>(sphereMeshCPU.indexArray.size());
+		level.baseVertex = static_cast<GLint>(sphereMeshCPU.vertexArray.size());
+		// egy felosztási négyszög közepe van a legmesszebb a gömbfelülettől, a fél átlójának megfelelő szögben
+		const float halfDiagonalAngle = 0.5f * std::sqrt(std::pow(glm::two_pi<float>() / N, 2.0f) + std::pow(glm::pi<float>() / M, 2.0f));
+		level.geometricError = m_sphereRadius * (1.0f - std::cos(halfDiagonalAngle));
+
+		sphereMeshCPU.vertexArray.insert(sphereMeshCPU.vertexArray.end(), lodMeshCPU.vertexArray.begin(), lodMeshCPU.vertexArray.end());
+		sphereMeshCPU.indexArray.insert(sphereMeshCPU.indexArray.end(), lodMeshCPU.indexArray.begin(), lodMeshCPU.indexArray.end());
+	}
+	m_sphereRange = m_geometryArena.Add(PackMesh(sphereMeshCPU));
+
+	for (std::size_t i = 0; i < m_newPositionVector.size(); ++i) SetSphereTransform(i);
+}
+
+void CMyApp::WriteDrawCommands(const GLuint* sphereInstanceCounts) {
+	// a lod. szint látható gömbjeinek indexei a m_visibleObjectsBufferID FIRST_SPHERE_SLOT + lod * kapacitás. elemétől
+	// kezdődnek; a példányonkénti attribútumot a baseInstance tolja oda
+	DrawElementsIndirectCommand commands[DRAW_COMMAND_COUNT];
+	for (int lod = 0; lod < SPHERE_LOD_COUNT; ++lod) {
+		commands[lod].count = m_sphereLods[lod].count;
+		commands[lod].instanceCount = sphereInstanceCounts != nullptr ? sphereInstanceCounts[lod] : 0;
+		commands[lod].firstIndex = m_sphereRange.firstIndex + m_sphereLods[lod].firstIndex;
+		commands[lod].baseVertex = m_sphereRange.baseVertex + m_sphereLods[lod].baseVertex;
+		commands[lod].baseInstance = static_cast<GLuint>(FIRST_SPHERE_SLOT + lod * m_visibleSpheresCapacity);
+	}
+
+	// a többi objektum eleme a saját slotja (ReserveVisibleObjects); a nem láthatóak 0 példánnyal
+	commands[SUZANNE_COMMAND] = DrawCommand(m_suzanneRange, IsObjectVisible(SUZANNE_SLOT) ? 1 : 0, SUZANNE_SLOT);
+	commands[PARAM_SURFACE_COMMAND] = DrawCommand(m_paramSurfaceRange, IsObjectVisible(PARAM_SURFACE_SLOT) ? 1 : 0, PARAM_SURFACE_SLOT);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_drawCommandBufferID);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(commands), commands);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+float CMyApp::LodPixelScale() const {
+	// a vetítés után 1 egység távolságban egy egységnyi méret ennyi pixel magas
+	return m_camera.GetProj()[1][1] * 0.5f * static_cast<float>(m_viewportHeight);
+}
+
+int CMyApp::SelectSphereLod(const glm::vec3& center) const {
+	// a gömb kamerához legközelebbi pontjának távolsága (a shaderben ugyanígy)
+	const float distance = std::max(glm::length(center - m_camera.GetEye()) - m_sphereRadius, 0.001f);
+	const float pixelsPerUnit = LodPixelScale() / distance;
+
+	for (int lod = SPHERE_LOD_COUNT - 1; lod > 0; --lod) {
+		if (m_sphereLods[lod].geometricError * pixelsPerUnit <= m_lodMaxPixelError) return lod;
+	}
+	return 0;
+}
+
+void CMyApp::SetSphereTransform(std::size_t sphereIndex) {
+	// a gömb csak eltolt, így a normálisokat nem kell transzformálni
+	SetObjectTransform(FIRST_SPHERE_SLOT + sphereIndex,
+					   glm::translate(m_newPositionVector[sphereIndex]) * m_sphereRange.quantization.Matrix(),
+					   glm::identity<glm::mat4>());
+	SetObjectBounds(FIRST_SPHERE_SLOT + sphereIndex, m_newPositionVector[sphereIndex], m_sphereRadius);
+}
+
+void CMyApp::InitObjectBuffers()
+{
+	glGenBuffers( 1, &m_frameUniformBufferID );
+	glBindBuffer( GL_UNIFORM_BUFFER, m_frameUniformBufferID );
+	glBufferData( GL_UNIFORM_BUFFER, sizeof( FrameUniforms ), nullptr, GL_DYNAMIC_DRAW );
+	glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+	glBindBufferBase( GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, m_frameUniformBufferID );
+
+	// a tárhelyet az első UploadObjectTransforms foglalja le
+	glGenBuffers( 1, &m_objectTransformBufferID );
+	m_objectBufferCapacity = 0;
+	m_objectTransforms.clear();
+	m_dirtyObjectsBegin = m_dirtyObjectsEnd = 0;
+}
+
+void CMyApp::CleanObjectBuffers()
+{
+	glDeleteBuffers( 1, &m_frameUniformBufferID );
+	glDeleteBuffers( 1, &m_objectTransformBufferID );
+	m_frameUniformBufferID = m_objectTransformBufferID = 0;
+}
+
+void CMyApp::BindObjectIndexAttribute( GLuint vaoID, GLuint objectIndexBufferID ) const
+{
+	// példányonként lép, így a base instance-szel indított rajzolásnál az első példány a base instance-edik elemet kapja
+	glBindVertexArray( vaoID );
+	glBindBuffer( GL_ARRAY_BUFFER, objectIndexBufferID );
+	glEnableVertexAttribArray( OBJECT_INDEX_ATTRIBUTE );
+	glVertexAttribIPointer( OBJECT_INDEX_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof( GLuint ), nullptr );
+	glVertexAttribDivisor( OBJECT_INDEX_ATTRIBUTE, 1 );
+	glBindVertexArray( 0 );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+void CMyApp::SetObjectTransform( std::size_t slot, const glm::mat4& world, const glm::mat4& worldIT )
+{
+	if ( slot >= m_objectTransforms.size() )
+	{
+		m_objectTransforms.resize( slot + 1, ObjectTransform{ glm::identity<glm::mat4>(), glm::identity<glm::mat4>() } );
+	}
+	m_objectTransforms[ slot ] = ObjectTransform{ world, worldIT };
+
+	if ( m_dirtyObjectsBegin == m_dirtyObjectsEnd )
+	{
+		m_dirtyObjectsBegin = slot;
+		m_dirtyObjectsEnd = slot + 1;
+	}
+	else
+	{
+		m_dirtyObjectsBegin = std::min( m_dirtyObjectsBegin, slot );
+		m_dirtyObjectsEnd = std::max( m_dirtyObjectsEnd, slot + 1 );
+	}
+}
+
+void CMyApp::SetObjectBounds( std::size_t slot, const glm::vec3& center, float radius )
+{
+	if ( slot >= m_objectBounds.Size() ) m_objectBounds.Resize( slot + 1 );
+	m_objectBounds.Set( slot, center, radius );
+}
+
+void CMyApp::CullObjectsOnCPU()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	m_visibleObjects.clear();
+	CullSpheres( ExtractFrustum( m_camera.GetViewProj() ), m_objectBounds, m_visibleObjects );
+
+	m_cullStats.timeMs = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	m_cullStats.visible = m_visibleObjects.size();
+	m_cullStats.culled = m_objectBounds.Size() - m_visibleObjects.size();
+}
+
+bool CMyApp::IsObjectVisible( std::size_t slot ) const
+{
+	return !m_cpuCulling || std::binary_search( m_visibleObjects.cbegin(), m_visibleObjects.cend(), static_cast<std::uint32_t>( slot ) );
+}
+
+void CMyApp::UploadObjectTransforms()
+{
+	if ( m_objectTransforms.size() > m_objectBufferCapacity )
+	{
+		// duplázva nő, így a gömbönkénti hozzáadás átlagosan csak az új elemet tölti fel
+		m_objectBufferCapacity = std::max<std::size_t>( 64, 2 * m_objectTransforms.size() );
+
+		glBindBuffer( GL_SHADER_STORAGE_BUFFER, m_objectTransformBufferID );
+		glBufferData( GL_SHADER_STORAGE_BUFFER, m_objectBufferCapacity * sizeof( ObjectTransform ), nullptr, GL_DYNAMIC_DRAW );
+		glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+		glBindBufferBase( GL_SHADER_STORAGE_BUFFER, OBJECT_TRANSFORM_BINDING, m_objectTransformBufferID );
+
+		m_dirtyObjectsBegin = 0;
+		m_dirtyObjectsEnd = m_objectTransforms.size();
+	}
+
+	if ( m_dirtyObjectsBegin == m_dirtyObjectsEnd ) return;
+
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, m_objectTransformBufferID );
+	glBufferSubData( GL_SHADER_STORAGE_BUFFER,
+					 m_dirtyObjectsBegin * sizeof( ObjectTransform ),
+					 ( m_dirtyObjectsEnd - m_dirtyObjectsBegin ) * sizeof( ObjectTransform ),
+					 m_objectTransforms.data() + m_dirtyObjectsBegin );
+	glBindBuffer( GL_SHADER_STORAGE_BUFFER, 0 );
+
+	m_dirtyObjectsBegin = m_dirtyObjectsEnd = 0;
+}
+
+void CMyApp::UploadFrameUniforms()
+{
+	const FrameUniforms frame{ m_camera.GetViewProj(), glm::vec4( m_camera.GetEye(), 1.0f ) };
+
+	glBindBuffer( GL_UNIFORM_BUFFER, m_frameUniformBufferID );
+	glBufferSubData( GL_UNIFORM_BUFFER, 0, sizeof( FrameUniforms ), &frame );
+	glBindBuffer( GL_UNIFORM_BUFFER, 0 );
 }
 
 void CMyApp::CleanGeometry()
 {
-	CleanOGLObject( m_SuzanneGPU );
+	m_geometryArena.Remove( m_suzanneRange );
 	CleanParametricSurfaceGeometry();
 	CleanParametricSphereGeometry();
+	m_geometryArena.Clean();
+
+	glDeleteBuffers( 1, &m_visibleObjectsBufferID );
+	glDeleteBuffers( 1, &m_drawCommandBufferID );
+	m_visibleObjectsBufferID = m_drawCommandBufferID = 0;
+
+	CleanObjectBuffers();
 }
 
 void CMyApp::CleanParametricSurfaceGeometry() {
-	CleanOGLObject( m_ParamSurfaceGPU );
+	m_geometryArena.Remove( m_paramSurfaceRange );
+	glDeleteVertexArrays( 1, &m_emptyVaoID );
+	m_emptyVaoID = 0;
 }
 
 void CMyApp::CleanParametricSphereGeometry() {
-	CleanOGLObject(m_ParamSphereGPU);
+	m_geometryArena.Remove(m_sphereRange);
 }
 
 void CMyApp::InitTextures()
 {
-	glGenTextures( 1, &m_SuzanneTextureID );
-	TextureFromFile( m_SuzanneTextureID, "Assets/Wood_Table_Texture.png" );
-	SetupTextureSampling( GL_TEXTURE_2D, m_SuzanneTextureID );
-
-	glGenTextures(1, &m_ParamSurfaceTextureID);
-	TextureFromFile(m_ParamSurfaceTextureID, "Assets/Wood_Table_Texture.png");
-	SetupTextureSampling(GL_TEXTURE_2D, m_ParamSurfaceTextureID);
+	m_woodTextureID = CreateTexture( GL_TEXTURE_2D );
+	TextureFromFile( m_woodTextureID, "Assets/Wood_Table_Texture.png" );
+	SetupTextureSampling( GL_TEXTURE_2D, m_woodTextureID );
 }
 
 void CMyApp::CleanTextures()
 {
-	glDeleteTextures( 1, &m_SuzanneTextureID );
-	glDeleteTextures( 1, &m_ParamSurfaceTextureID );
+	glDeleteTextures( 1, &m_woodTextureID );
 }
 
 bool CMyApp::Init()
@@ -163,6 +387,7 @@ bool CMyApp::Init()
 	glClearColor(0.125f, 0.25f, 0.5f, 1.0f);
 
 	InitShaders();
+	InitObjectBuffers(); // a geometria már ide írja a transzformációit
 	InitGeometry();
 	InitTextures();
 
@@ -175,6 +400,9 @@ bool CMyApp::Init()
 
 	glEnable(GL_DEPTH_TEST); // mélységi teszt bekapcsolása (takarás)
 
+	// a háromszögsávok elválasztója az index típus legnagyobb értéke (PRIMITIVE_RESTART_INDEX)
+	glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+
 	// kamera
 	m_camera.SetView(
 		glm::vec3(0.0, 0.0,	m_camera.GetDistance()),					// honnan nézzük a színteret	   - eye
@@ -209,103 +437,170 @@ void CMyApp::Render()
 	// kamera forgatása az objektum körül 
 	m_camera.UpdateU();
 	
-	glUseProgram( m_programID );
+	// kamera (FrameData) és a változott objektum transzformációk (ObjectTransforms) feltöltése
+	UploadFrameUniforms();
+	UploadObjectTransforms();
 
-	// ******* SUZANNE ********
-	glBindVertexArray( m_SuzanneGPU.vaoID );
+	// a látható objektumok kiválogatása, még a rajzolás előtt
+	if ( m_cpuCulling ) CullObjectsOnCPU();
+	CullGeneratedObjects();
 
-	// - Textúrák beállítása, minden egységre külön
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_SuzanneTextureID);
+	// a rajzolások összegyűjtése; a Submit (program, VAO, textúra, mélység) szerint rendezi őket,
+	// és csak a változó állapotot köti újra, a végén pedig mindent lekapcsol
+	m_renderQueue.Clear();
 
-	glm::mat4 matWorld = glm::identity<glm::mat4>();
-	matWorld = glm::translate( SUZANNE_POS );
+	// ******* Suzanne, a gömbök és a VBO-s fánk ********
+	QueueArenaGeometry();
+	// ************************************************************************************ 
 
-	glUniformMatrix4fv( ul( "viewProj" ), 1, GL_FALSE, glm::value_ptr( m_camera.GetViewProj() ) );
-	glUniformMatrix4fv( ul( "world" ),    1, GL_FALSE, glm::value_ptr( matWorld ) );
-	glUniformMatrix4fv( ul( "worldIT" ),  1, GL_FALSE, glm::value_ptr( glm::transpose( glm::inverse( matWorld ) ) ) );
-	// - textúraegységek beállítása
-	glUniform1i( ul( "texImage" ), 0 );
+	// ******* Parametric (vertex shaderben) ********
+	QueueParametricSurface();
+	// ************************************************************************************ 
 
-	glDrawElements( GL_TRIANGLES,    
-					m_SuzanneGPU.count,			 
-					GL_UNSIGNED_INT,
-					nullptr );
+	m_renderQueue.Submit();
+}
 
-	// - Textúrák kikapcsolása, minden egységre külön
-	glActiveTexture( GL_TEXTURE0 );
-	glBindTexture( GL_TEXTURE_2D, 0 );
+void CMyApp::ReserveVisibleObjects(std::size_t sphereCount) {
+	if (m_visibleSpheresCapacity != 0 && sphereCount <= m_visibleSpheresCapacity) return;
 
-	// VAO kikapcsolása
-	glBindVertexArray( 0 );
-	// ************************************************************************************ 
+	// az elején a nem gömb objektumok elemei, utána LOD-onként egy-egy rész;
+	// a VAO a buffer nevére hivatkozik, így az újrafoglalás után sem kell újra beállítani
+	m_visibleSpheresCapacity = std::max<std::size_t>(64, 2 * sphereCount);
+	glBindBuffer(GL_ARRAY_BUFFER, m_visibleObjectsBufferID);
+	glBufferData(GL_ARRAY_BUFFER, (FIRST_SPHERE_SLOT + SPHERE_LOD_COUNT * m_visibleSpheresCapacity) * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
 
-	// ******* Parametric ********
-	RenderParametricSurface();
-	// ************************************************************************************ 
+	// Suzanne és a fánk egyetlen példánya a saját slotját kapja (a parancsuk baseInstance-e a slot)
+	GLuint staticObjects[FIRST_SPHERE_SLOT];
+	std::iota(std::begin(staticObjects), std::end(staticObjects), 0u);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(staticObjects), staticObjects);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-	// ******* Generált objektum ********
-	for (auto pos : m_newPositionVector) {
-		RenderGeneratedObject(pos);
-	}
-	// ************************************************************************************ 
+void CMyApp::CullGeneratedObjects() {
+	const std::size_t sphereCount = m_newPositionVector.size();
+	ReserveVisibleObjects(sphereCount);
 
-	// shader kikapcsolasa
-	glUseProgram(0);
-}
+	if (m_cpuCulling)
+	{
+		// A CPU-n kiválogatott gömbök (a növekvő m_visibleObjects vége) LOD-onként szétosztva és feltöltve.
+		// A (LOD, távolság) kulcsú radix rendezés után a szintek egymás után, szintenként elöl a közelebbi gömbök jönnek,
+		// így a példányok is elölről hátrafelé rajzolódnak (early-Z). A GPU-s vizsgálat kimenetének sorrendje tetszőleges.
+		const std::size_t firstSphere = std::lower_bound(m_visibleObjects.cbegin(), m_visibleObjects.cend(), static_cast<std::uint32_t>(FIRST_SPHERE_SLOT)) - m_visibleObjects.cbegin();
+
+		m_sphereSortItems.clear();
+		for (std::size_t i = firstSphere; i < m_visibleObjects.size(); ++i) {
+			const std::uint32_t objectIndex = m_visibleObjects[i];
+			const glm::vec3& center = m_newPositionVector[objectIndex - FIRST_SPHERE_SLOT];
+			const std::uint64_t lod = static_cast<std::uint64_t>(SelectSphereLod(center));
+			m_sphereSortItems.push_back(SortItem{ (lod << 32) | FloatSortKey(glm::length(center - m_camera.GetEye())), objectIndex });
+		}
+		RadixSort(m_sphereSortItems, m_sphereSortScratch);
+
+		for (std::vector<GLuint>& bucket : m_sphereLodBuckets) bucket.clear();
+		for (const SortItem& item : m_sphereSortItems) m_sphereLodBuckets[item.key >> 32].push_back(item.value);
+
+		GLuint instanceCounts[SPHERE_LOD_COUNT];
+		glBindBuffer(GL_ARRAY_BUFFER, m_visibleObjectsBufferID);
+		for (int lod = 0; lod < SPHERE_LOD_COUNT; ++lod) {
+			const std::vector<GLuint>& bucket = m_sphereLodBuckets[lod];
+			instanceCounts[lod] = static_cast<GLuint>(bucket.size());
+			m_cullStats.spheresPerLod[lod] = bucket.size();
+			if (!bucket.empty()) {
+				glBufferSubData(GL_ARRAY_BUFFER, (FIRST_SPHERE_SLOT + lod * m_visibleSpheresCapacity) * sizeof(GLuint), bucket.size() * sizeof(GLuint), bucket.data());
+			}
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-void CMyApp::RenderGeneratedObject(glm::vec3 objectPosition) {
-	glUseProgram(m_programID); // shader bekapcsolás
-	glBindVertexArray(m_ParamSphereGPU.vaoID);
+		WriteDrawCommands(instanceCounts);
+		return;
+	}
 
-	// Textúrázás
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_ParamSurfaceTextureID);
+	// a látható példányok számát a shader atomikusan növeli, ezért minden képkocka előtt nullázzuk
+	WriteDrawCommands(nullptr);
+	if (sphereCount == 0) return;
 
-	glm::mat4 matWorld = glm::translate(objectPosition); // objektum eltranszformálása az adott pozícióba
-	// leküldjük a world-ot és annak inverzét
-	glUniformMatrix4fv(ul("world"), 1, GL_FALSE, glm::value_ptr(matWorld));
-	glUniformMatrix4fv(ul("worldIT"), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(matWorld))));
+	glUseProgram(m_cullProgramID);
 
-	// Suzanne kirajzolása
-	glDrawElements(GL_TRIANGLES,
-				   m_SuzanneGPU.count,
-				   GL_UNSIGNED_INT,
-				   nullptr);
+	const Frustum frustum = ExtractFrustum(m_camera.GetViewProj());
+	SetUniform(m_cullUniforms.frustumPlanes, frustum.planes, Frustum::PLANE_COUNT);
+	SetUniform(m_cullUniforms.firstObject, static_cast<GLuint>(FIRST_SPHERE_SLOT));
+	SetUniform(m_cullUniforms.objectCount, static_cast<GLuint>(sphereCount));
+	SetUniform(m_cullUniforms.boundingRadius, m_sphereRadius);
 
-	// Textúrák kikapcsolása
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	
-	// VAO kikapcsolása
-	glBindVertexArray(0);
-	
-	// Shader kikapcsolása
-	glUseProgram(0);
-}
+	GLfloat lodErrors[SPHERE_LOD_COUNT];
+	for (int lod = 0; lod < SPHERE_LOD_COUNT; ++lod) lodErrors[lod] = m_sphereLods[lod].geometricError;
+	SetUniform(m_cullUniforms.lodCapacity, static_cast<GLuint>(m_visibleSpheresCapacity));
+	SetUniform(m_cullUniforms.lodErrors, lodErrors, SPHERE_LOD_COUNT);
+	SetUniform(m_cullUniforms.lodPixelScale, LodPixelScale());
+	SetUniform(m_cullUniforms.lodMaxPixelError, m_lodMaxPixelError);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_OBJECTS_BINDING, m_visibleObjectsBufferID);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_DRAW_COMMAND_BINDING, m_drawCommandBufferID);
 
-void CMyApp::RenderParametricSurface() {
-	glBindVertexArray(m_ParamSurfaceGPU.vaoID);
+	constexpr GLuint CULL_GROUP_SIZE = 64; // local_size_x a shaderben
+	glDispatchCompute(static_cast<GLuint>((sphereCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE), 1, 1);
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_ParamSurfaceTextureID);
+	// a rajzolás a parancsokat és az indexeket csúcsattribútumként olvassa
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
 
-	glm::mat4 matWorld = glm::translate(glm::vec3(0.0, -3.0, 0.0));
+	glUseProgram(0);
+}
 
-	glUniformMatrix4fv(ul("world"), 1, GL_FALSE, glm::value_ptr(matWorld));
-	glUniformMatrix4fv(ul("worldIT"), 1, GL_FALSE, glm::value_ptr(glm::transpose(glm::inverse(matWorld))));
+float CMyApp::ObjectDistance(std::size_t slot) const {
+	const glm::vec3 center(m_objectBounds.CenterX()[slot], m_objectBounds.CenterY()[slot], m_objectBounds.CenterZ()[slot]);
+	return glm::length(center - m_camera.GetEye());
+}
 
-	glDrawElements(GL_TRIANGLES,
-		m_ParamSurfaceGPU.count,
-		GL_UNSIGNED_INT,
-		nullptr);
+void CMyApp::QueueArenaGeometry() {
+	// A háromszöglisták (a gömb LOD-ok és Suzanne) egyetlen hívással. A példányszámokat a CullGeneratedObjects írta
+	// a parancsokba (a nem látható objektumoké 0), az i. példány transzformációja a m_visibleObjectsBufferID baseInstance + i. eleme.
+	// Az egész hívás egy textúrával rajzol, ezért Suzanne és a gömbök ugyanazt a textúra objektumot használják.
+	DrawItem lists;
+	lists.program = m_programID;
+	lists.vao = m_geometryArena.VaoID();
+	lists.texture = m_woodTextureID;
+	lists.indirectBuffer = m_drawCommandBufferID;
+	lists.depth = ObjectDistance(SUZANNE_SLOT);
+	lists.kind = DrawItem::Kind::ElementsIndirect;
+	lists.mode = GL_TRIANGLES;
+	lists.indexType = m_geometryArena.IndexType();
+	lists.indirectOffset = 0;
+	lists.count = SUZANNE_COMMAND + 1;
+	m_renderQueue.Push(lists);
+
+	// a háromszögsávos fánk más primitív típus, így külön hívás (a vertex shaderes módban üres, nincs mit rajzolni)
+	if (m_paramSurfaceRange.indexCount > 0 && IsObjectVisible(PARAM_SURFACE_SLOT)) {
+		DrawItem strip = lists;
+		strip.depth = ObjectDistance(PARAM_SURFACE_SLOT);
+		strip.mode = m_paramSurfaceRange.primitiveType;
+		strip.indirectOffset = PARAM_SURFACE_COMMAND * sizeof(DrawElementsIndirectCommand);
+		strip.count = 1;
+		m_renderQueue.Push(strip);
+	}
+}
 
-	// - Textúrák kikapcsolása, minden egységre külön
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+void CMyApp::QueueParametricSurface() {
+	// a VBO-s fánkot a QueueArenaGeometry rajzolja
+	if (!m_paramSurfaceOnGPU || !IsObjectVisible(PARAM_SURFACE_SLOT)) return;
+
+	// N x M négyszög, négyszögenként 6 csúcs; a felbontás és a tórusz paraméterei a program uniformjai (InitShaders)
+	DrawItem surface;
+	surface.program = m_paramSurfaceProgramID;
+	surface.vao = m_emptyVaoID;
+	surface.texture = m_woodTextureID;
+	surface.depth = ObjectDistance(PARAM_SURFACE_SLOT);
+	surface.kind = DrawItem::Kind::Arrays;
+	surface.mode = GL_TRIANGLES;
+	surface.first = 0;
+	surface.count = 6 * m_resolutionN * m_resolutionM;
+	m_renderQueue.Push(surface);
+}
 
-	// VAO kikapcsolása
-	glBindVertexArray(0);
+void CMyApp::UploadParamSurfaceResolution() {
+	glUseProgram(m_paramSurfaceProgramID);
+	SetUniform(m_paramSurfaceUniforms.resolutionN, static_cast<GLuint>(m_resolutionN));
+	SetUniform(m_paramSurfaceUniforms.resolutionM, static_cast<GLuint>(m_resolutionM));
+	glUseProgram(0);
 }
 
 void CMyApp::RenderGUI()
@@ -331,33 +626,59 @@ void CMyApp::RenderGUI()
 		if (ImGui::Button("Alakzat létrehozása")) {
 			// az új pozíciót csak akkor vesszük fel, ha nincs olyan objektum, amivel ütközne
 			if (!HasCollidingSpheres(m_newObjectPosition)) {
-				m_newPositionVector.push_back(m_newObjectPosition);
-				// ha még nem volt következő objektum, és sikerült létrehozni egyet,
-				// akkor beállítjuk azt, vagyis az első, mint a kövi objektum
-				if (m_nextPosition == -1) {
-					m_nextPosition = 0;
-				}
-				// ez az az eset, amikor az utolsó objektumon állunk, nem tudunk tovább teleportálni,
-				// és létrehozunk egy újat
-				else if (m_nextPosition == m_newPositionVector.size() - 2) {
-					m_nextPosition++;
-				}
-
+				AppendSpheres({ m_newObjectPosition });
 			}
 		}
 
+		// ********* TÖMEGES GENERÁLÁS *********
+		// a (X, Y, Z) sarokból induló, megadott élhosszú kockát tölti ki egymással (és a meglévőkkel) nem ütköző gömbökkel
+		ImGui::SliderFloat("Kocka élhossza", &m_bulkBoxSize, 10.0f, 1000.0f, "%.0f");
+		const glm::vec3 bulkBoxMax = m_newObjectPosition + glm::vec3(m_bulkBoxSize);
+		const bool isBulkBoxTooLarge = PoissonDiskCellCount(m_newObjectPosition, bulkBoxMax, 2.0f * m_sphereRadius) > POISSON_DISK_MAX_CELLS;
+		if (ImGui::Button("Gömbök generálása") && !isBulkBoxTooLarge) {
+			GenerateSpheres(m_newObjectPosition, bulkBoxMax);
+		}
+		ImGui::SameLine();
+		ImGui::Text("%zu gömb", m_newPositionVector.size());
+		if (isBulkBoxTooLarge) {
+			ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "A kocka túl nagy a háttérrácshoz, kisebb élhossz kell");
+		}
+
+		// ********* LÁTHATÓSÁG *********
+		ImGui::Checkbox("CPU-s láthatósági vizsgálat (SIMD)", &m_cpuCulling);
+		ImGui::SliderFloat("LOD pixel hiba", &m_lodMaxPixelError, 0.1f, 10.0f);
+		if (m_cpuCulling) {
+			ImGui::Text("Látható: %zu, eldobott: %zu, %.3f ms", m_cullStats.visible, m_cullStats.culled, m_cullStats.timeMs);
+			ImGui::Text("Gömbök LOD-onként: %zu / %zu / %zu / %zu", m_cullStats.spheresPerLod[0], m_cullStats.spheresPerLod[1],
+						m_cullStats.spheresPerLod[2], m_cullStats.spheresPerLod[3]);
+		}
+		else {
+			ImGui::Text("A gömbök vizsgálata a GPU-n (compute shader)");
+		}
+		ImGui::Text("Rajzolási elemek: %zu, állapotváltások: %zu", m_renderQueue.ItemCount(), m_renderQueue.StateChangeCount());
+
 		if (ImGui::Button("TELEPORT!")) {
 			TeleportToNextObject();
 		}
 
 		// ********* FELBONTÁS *********
+		// a shaderben kiértékelt fánknál a felbontás csak uniform, nem kell újraépíteni
+		const bool isModeChanged = ImGui::Checkbox("Fánk a vertex shaderben (VBO nélkül)", &m_paramSurfaceOnGPU);
 		const bool isNChanged = ImGui::SliderInt("Folbontás N", &m_resolutionN, 1, 100);
 		const bool isMChanged = ImGui::SliderInt("Folbontás M", &m_resolutionM, 1, 100);
-		if (isNChanged || isMChanged) 
+		if (isNChanged || isMChanged)
+		{
+			UploadParamSurfaceResolution(); // VBO-s módban is, hogy a visszaváltáskor naprakész legyen
+		}
+		if (isModeChanged)
 		{
 			CleanParametricSurfaceGeometry();
 			InitParametricSurfaceGeometry();
 		}
+		else if (!m_paramSurfaceOnGPU && (isNChanged || isMChanged))
+		{
+			InitParametricSurfaceGeometry(); // az arénabeli hely frissítése (vagy újrafoglalása, ha a háló nőtt)
+		}
 	}
 	ImGui::End();
 }
@@ -374,23 +695,58 @@ void CMyApp::ChangeTitle() {
 	SDL_SetWindowTitle(win, window_title.str().c_str());
 }
 
-bool CMyApp::HasCollidingSpheres(glm::vec3 newPositions) {
-	// végigiterálunk az összes eddig pozíción, megnézzük, hogy
-	// bármelyikkel ütküzik-e az újonnan felvenni kívánt gömbünk,
-	// erre az alábbi algoritmust használjuk
-	for (auto sphere : m_newPositionVector) {
-		float distance = std::sqrt(
-			std::pow(newPositions.x - sphere.x, 2) +
-			std::pow(newPositions.y - sphere.y, 2) +
-			std::pow(newPositions.z - sphere.z, 2)
-		);
-
-		if (distance <= 2 * m_sphereRadius) {
-			return true;
-		}
+void CMyApp::AppendSpheres(const std::vector<glm::vec3>& positions) {
+	if (positions.empty()) return;
+
+	const std::size_t oldCount = m_newPositionVector.size();
+	m_newPositionVector.insert(m_newPositionVector.end(), positions.begin(), positions.end());
+	m_sphereGrid.Insert(positions, m_sphereRadius);
+	for (std::size_t i = oldCount; i < m_newPositionVector.size(); ++i) SetSphereTransform(i);
+
+	// ha még nem volt következő objektum, akkor az első új gömb lesz az
+	if (m_nextPosition == -1) {
+		m_nextPosition = 0;
+	}
+	// ez az az eset, amikor az utolsó objektumon állunk, nem tudunk tovább teleportálni:
+	// a sorban következő az első új gömb, utána az újak a generálás sorrendjében jönnek
+	else if (m_nextPosition == static_cast<int>(oldCount) - 1) {
+		m_nextPosition = static_cast<int>(oldCount);
+	}
+}
+
+void CMyApp::GenerateSpheres(const glm::vec3& boxMin, const glm::vec3& boxMax) {
+	PoissonDiskSettings settings;
+	settings.minDistance = 2.0f * m_sphereRadius;
+	settings.seed = m_newPositionVector.size(); // hogy az ismételt generálás más mintát adjon
+
+	std::vector<glm::vec3> positions = GeneratePoissonDisk(boxMin, boxMax, settings);
+	if (positions.empty()) {
+		SDL_LogMessage(SDL_LOG_CATEGORY_ERROR,
+					   SDL_LOG_PRIORITY_ERROR,
+					   "[GenerateSpheres] The box is empty or too large for the background grid.");
+		return;
 	}
 
-	return false;
+	// a már meglévő gömbökkel ütközőket kiszűrjük; a rács csak olvasott, így ez is párhuzamos lehet
+	std::vector<std::uint8_t> keep(positions.size());
+	constexpr std::size_t CHUNK_SIZE = 4096;
+	ThreadPool::Global().ParallelFor((positions.size() + CHUNK_SIZE - 1) / CHUNK_SIZE, [&](std::size_t chunk) {
+		const std::size_t end = std::min(positions.size(), (chunk + 1) * CHUNK_SIZE);
+		for (std::size_t i = chunk * CHUNK_SIZE; i < end; ++i) keep[i] = !m_sphereGrid.Overlaps(positions[i], m_sphereRadius);
+	});
+
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < positions.size(); ++i) {
+		if (keep[i]) positions[kept++] = positions[i];
+	}
+	positions.resize(kept);
+
+	AppendSpheres(positions);
+}
+
+bool CMyApp::HasCollidingSpheres(glm::vec3 newPositions) {
+	// rácsban keresünk: csak a szomszédos cellák gömbjeit kell megnézni, nem az összeset
+	return m_sphereGrid.Overlaps(newPositions, m_sphereRadius);
 }
 
 void CMyApp::TeleportToNextObject() {
@@ -408,18 +764,6 @@ void CMyApp::TeleportToNextObject() {
 	}
 }
 
-GLint CMyApp::ul( const char* uniformName ) noexcept
-{
-	GLuint programID = 0;
-
-	// Kérdezzük le az aktuális programot!
-	// https://registry.khronos.org/OpenGL-Refpages/gl4/html/glGet.xhtml
-	glGetIntegerv( GL_CURRENT_PROGRAM, reinterpret_cast<GLint*>( &programID ) );
-	// A program és a uniform név ismeretében kérdezzük le a location-t!
-	// https://registry.khronos.org/OpenGL-Refpages/gl4/html/glGetUniformLocation.xhtml
-	return glGetUniformLocation( programID, uniformName );
-}
-
 // https://wiki.libsdl.org/SDL2/SDL_KeyboardEvent
 // https://wiki.libsdl.org/SDL2/SDL_Keysym
 // https://wiki.libsdl.org/SDL2/SDL_Keycode
@@ -485,5 +829,6 @@ void CMyApp::Resize(int _w, int _h)
 {
 	glViewport(0, 0, _w, _h);
 	m_camera.Resize( _w, _h );
+	m_viewportHeight = _h;
 }
 
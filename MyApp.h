@@ -15,7 +15,11 @@
 
 // Utils
 #include "GLUtils.hpp"
+#include "GeometryArena.hpp"
+#include "RenderQueue.hpp"
 #include "Camera.h"
+#include "SphereCollision.hpp"
+#include "Frustum.hpp"
 
 static std::string title = "Alap fejlec";
 
@@ -32,6 +36,38 @@ const std::initializer_list<VertexAttributeDescriptor> vertexAttribList =
 	{ 2, offsetof(Vertex, texcoord), 2, GL_FLOAT },
 };
 
+// ugyanezek a tömörített csúcsokhoz (VertexPacked): a pozíció és a normális normalizált egészként érkezik,
+// a shader a normálist oktaéder kódolásból fejti vissza, a pozíciót a GeometryRange::quantization skálázza vissza
+const std::initializer_list<VertexAttributeDescriptor> vertexPackedAttribList =
+{
+	{ 0, offsetof(VertexPacked, position), 3, GL_SHORT, GL_TRUE },
+	{ 1, offsetof(VertexPacked, normal), 2, GL_BYTE, GL_TRUE },
+	{ 2, offsetof(VertexPacked, texcoord), 2, GL_HALF_FLOAT },
+};
+
+// a shaderek FrameData uniform blokkja (std140): képkockánként egyszer töltjük fel
+struct FrameUniforms
+{
+	glm::mat4 viewProj;
+	glm::vec4 cameraPos; // w nem használt, std140-ben a vec3 is 16 bájtot foglal
+};
+
+// a shaderek ObjectTransforms tömbjének (SSBO, std430) egy eleme
+struct ObjectTransform
+{
+	glm::mat4 world;
+	glm::mat4 worldIT;
+};
+
+// binding pontok, a shaderek layout( binding = ... ) értékeivel egyezően
+constexpr GLuint FRAME_UNIFORM_BINDING = 0;
+constexpr GLuint OBJECT_TRANSFORM_BINDING = 0;
+constexpr GLuint VISIBLE_OBJECTS_BINDING = 1;  // Comp_CullSpheres.comp kimenetei
+constexpr GLuint CULL_DRAW_COMMAND_BINDING = 2;
+// a kirajzolt objektum sorszáma az ObjectTransforms tömbben: példányonként lépő csúcsattribútum, amit
+// a rajzolás base instance-e tol el (GL 4.3-ban a shader még nem látja a gl_BaseInstance-t / gl_DrawID-t)
+constexpr GLuint OBJECT_INDEX_ATTRIBUTE = 3;
+
 class CMyApp
 {
 private:
@@ -68,13 +104,16 @@ protected:
 	glm::vec3 m_newObjectPosition{ 0.0f, 0.0f, 0.0f }; // az új objektum pozíciója, ezt olvassuk be a UI-ból
 	std::vector<glm::vec3> m_newPositionVector{}; // ebben tároljuk az újonnan létrehozott gömbök koordinátáit
 	int m_nextPosition = -1; // teleport esetén a következő pozíció, kezdetben -1, mert nincs ilyen
+	float m_bulkBoxSize = 100.0f; // a tömeges generálásnál kitöltött kocka élhossza
 
 	float m_ElapsedTimeInSec = 0.0f;
 
 	int m_resolutionN = 50; // kezdeti felbontása a fánknak
 	int m_resolutionM = 50; // szintén
+	bool m_paramSurfaceOnGPU = true; // a fánk csúcsait a vertex shader számolja (nincs VBO/IBO, a felbontás váltása ingyenes)
 
 	const float m_sphereRadius = 2.0f; // gömb sugara
+	SphereGrid m_sphereGrid{ 2.0f * m_sphereRadius }; // m_newPositionVector gömbjei rácsba rendezve, az ütközésvizsgálathoz
 
 	// Suzanne params
 	static constexpr glm::vec3 SUZANNE_POS = glm::vec3( 0.0f, 0.0f, 0.0f );
@@ -91,11 +130,84 @@ protected:
 	// OpenGL-es dolgok
 	//
 	
-	// uniform location lekérdezése
-	GLint ul( const char* uniformName ) noexcept;
-
 	// shaderekhez szükséges változók
 	GLuint m_programID = 0; // shaderek programja
+	ProgramUniforms m_programUniforms; // m_programID aktív uniformjai
+
+	// a rajzoláskor használt uniformok, az InitShaders-ben egyszer kikeresve
+	// (a kamera a FrameData blokkban, az objektumok transzformációi az ObjectTransforms SSBO-ban vannak)
+	struct
+	{
+		UniformHandle<GLint> texImage;
+	} m_uniforms;
+
+	// az attribútum nélküli parametrikus felület programja (Vert_ParamSurface.vert), és a uniformjai
+	GLuint m_paramSurfaceProgramID = 0;
+	ProgramUniforms m_paramSurfaceProgramUniforms;
+	struct
+	{
+		UniformHandle<GLint>   texImage;
+		UniformHandle<GLuint>  objectIndex;
+		UniformHandle<GLuint>  resolutionN;
+		UniformHandle<GLuint>  resolutionM;
+		UniformHandle<GLfloat> torusA;
+		UniformHandle<GLfloat> torusB;
+	} m_paramSurfaceUniforms;
+
+	// a generált gömbök láthatósági vizsgálata (compute shader), és a uniformjai
+	GLuint m_cullProgramID = 0;
+	ProgramUniforms m_cullProgramUniforms;
+	struct
+	{
+		UniformHandle<glm::vec4> frustumPlanes;
+		UniformHandle<GLuint>    firstObject;
+		UniformHandle<GLuint>    objectCount;
+		UniformHandle<GLfloat>   boundingRadius;
+		UniformHandle<GLuint>    lodCapacity;
+		UniformHandle<GLfloat>   lodErrors;
+		UniformHandle<GLfloat>   lodPixelScale;
+		UniformHandle<GLfloat>   lodMaxPixelError;
+	} m_cullUniforms;
+
+	// az objektumok helye az ObjectTransforms tömbben: Suzanne, a tórusz, majd a gömbök sorban
+	static constexpr std::size_t SUZANNE_SLOT = 0;
+	static constexpr std::size_t PARAM_SURFACE_SLOT = 1;
+	static constexpr std::size_t FIRST_SPHERE_SLOT = 2;
+	static constexpr int SPHERE_LOD_COUNT = 4; // a gömb részletességi szintjeinek száma
+
+	// a m_drawCommandBufferID parancsai: elöl a gömb LOD-oké (ezeket írja a culling shader), utána Suzanne-é és a fánké
+	static constexpr int SUZANNE_COMMAND = SPHERE_LOD_COUNT;
+	static constexpr int PARAM_SURFACE_COMMAND = SPHERE_LOD_COUNT + 1;
+	static constexpr int DRAW_COMMAND_COUNT = SPHERE_LOD_COUNT + 2;
+
+	GLuint m_frameUniformBufferID = 0;	  // FrameData (UBO)
+	GLuint m_objectTransformBufferID = 0; // ObjectTransforms (SSBO)
+	std::size_t m_objectBufferCapacity = 0;				// ennyi objektum fér a fenti bufferbe
+	std::vector<ObjectTransform> m_objectTransforms{};	// az SSBO CPU oldali másolata
+	std::size_t m_dirtyObjectsBegin = 0;				// [begin, end): a változott, még fel nem töltött elemek
+	std::size_t m_dirtyObjectsEnd = 0;
+
+	// a láthatósági vizsgálat: a compute shaderes (csak a gömbök) vagy a CPU-s SIMD-es (minden objektum)
+	bool m_cpuCulling = false;
+	BoundingSphereArray m_objectBounds;				 // slotonként a befoglaló gömb, mint az m_objectTransforms
+	std::vector<std::uint32_t> m_visibleObjects{};	 // a CPU-s vizsgálat eredménye: a látható slotok, növekvő sorrendben
+	struct
+	{
+		std::size_t visible = 0;
+		std::size_t culled = 0;
+		float       timeMs = 0.0f;
+		std::size_t spheresPerLod[ SPHERE_LOD_COUNT ] = {};
+	} m_cullStats; // az utolsó CPU-s vizsgálat, a UI-nak
+
+	void InitObjectBuffers();
+	void CleanObjectBuffers();
+	void SetObjectBounds( std::size_t slot, const glm::vec3& center, float radius );
+	void CullObjectsOnCPU(); // m_visibleObjects és m_cullStats kitöltése
+	bool IsObjectVisible( std::size_t slot ) const; // a GPU-s vizsgálatnál mindig igaz
+	void SetObjectTransform( std::size_t slot, const glm::mat4& world, const glm::mat4& worldIT );
+	void UploadObjectTransforms(); // csak a változott elemeket tölti fel
+	void UploadFrameUniforms();
+	void BindObjectIndexAttribute( GLuint vaoID, GLuint objectIndexBufferID ) const;
 
 	// Fényforrás- ...
 	glm::vec4 m_lightPos = glm::vec4( 0.0f, 1.0f, 0.0f, 0.0f );
@@ -124,28 +236,63 @@ protected:
 	void InitShaders();
 	void CleanShaders();
 
-	// Geometriával kapcsolatos változók
-	OGLObject m_SuzanneGPU = {};	  // Suzanne
-	OGLObject m_ParamSurfaceGPU = {}; // Parametrikus felület
-	OGLObject m_ParamSphereGPU = {};
-	std::vector<OGLObject> m_generatedObjects{}; // vektorban eltároljuk a helyét az újonnan generált objektumoknak
+	// Geometriával kapcsolatos változók: minden háló a közös arénában, egy VAO-val
+	GeometryArena m_geometryArena;
+	GeometryRange m_suzanneRange;	   // Suzanne
+	GeometryRange m_paramSurfaceRange; // Parametrikus felület (csak ha !m_paramSurfaceOnGPU, különben üres)
+	GeometryRange m_sphereRange;	   // a gömb összes részletességi szintje (LOD) egymás után
+	MeshObject<Vertex> m_paramSurfaceMeshCPU;	// a felbontás változásakor újrahasznosított CPU-s tömbök
+	PackedMesh m_paramSurfacePackedCPU;
+	GLuint m_emptyVaoID = 0;		  // az attribútum nélküli rajzoláshoz (core profilban is kell kötött VAO)
+	GLuint m_visibleObjectsBufferID = 0;	  // az aréna VAO 3. attribútuma: a nem gömb objektumok slotjai, majd LOD-onként a látható gömbök (a culling kimenete)
+	GLuint m_drawCommandBufferID = 0;		  // DRAW_COMMAND_COUNT db DrawElementsIndirectCommand, képkockánként újraírva
+	std::size_t m_visibleSpheresCapacity = 0; // LOD-onként ennyi gömb indexe fér a m_visibleObjectsBufferID-be
+
+	// a gömb LOD lánca, a legrészletesebbtől; egy gömb azt a legdurvább szintet kapja,
+	// aminek a geometriai hibája a képernyőn legfeljebb m_lodMaxPixelError pixel
+	struct SphereLod
+	{
+		GLuint count = 0;			  // indexek száma
+		GLuint firstIndex = 0;		  // az első index helye a m_sphereRange-en belül
+		GLint  baseVertex = 0;		  // az első csúcs helye a m_sphereRange-en belül
+		float  geometricError = 0.0f; // a háló legnagyobb eltérése a gömbfelülettől (világkoordinátában)
+	};
+	SphereLod m_sphereLods[ SPHERE_LOD_COUNT ];
+	std::vector<GLuint> m_sphereLodBuckets[ SPHERE_LOD_COUNT ]; // a CPU-s vizsgálatnál LOD-onként a látható gömbök, elöl a közelebbiek
+	std::vector<SortItem> m_sphereSortItems;					 // (LOD, távolság) kulccsal a bucket-ek feltöltéséhez
+	std::vector<SortItem> m_sphereSortScratch;
+	float m_lodMaxPixelError = 1.0f;
+	int m_viewportHeight = 600; // a LOD választáshoz; a Resize frissíti
+
+	int SelectSphereLod( const glm::vec3& center ) const;  // a CullGeneratedObjects-ben a compute shader ugyanezt számolja
+	float LodPixelScale() const;						  // világ- -> képernyő méret szorzó 1 egység távolságban
+	void WriteDrawCommands( const GLuint* sphereInstanceCounts ); // a gömböknél LOD-onként a példányszámmal (vagy 0-val, ha nullptr)
+	void ReserveVisibleObjects( std::size_t sphereCount );		   // a m_visibleObjectsBufferID mérete legalább sphereCount gömbhöz
 
 	// Geometria inicializálása, és törlése
 	void InitGeometry();
-	void InitParametricSurfaceGeometry();
+	void InitParametricSurfaceGeometry(); // ha a fánk már fel van töltve, a puffereit helyben frissíti
 	void InitParametricSphereGeometry();
 	void CleanGeometry();
 	void CleanParametricSurfaceGeometry(); 
 	void CleanParametricSphereGeometry();
-
-	void RenderGeneratedObject(glm::vec3 objectPosition); // metódus, ami meghívódik minden egyes alkalommal, mikor a 
-														  // felhasználó létre akar hozni egy új objektumot az adott pozícióba
-	void RenderParametricSurface();
+	void SetSphereTransform( std::size_t sphereIndex ); // m_newPositionVector[ sphereIndex ] gömbjének transzformációja
+
+	void CullGeneratedObjects(); // a látható gömbök kiválogatása (GPU-n vagy a CPU-s eredményből) és a parancsok megírása
+	// a képkocka rajzolásai; a Render gyűjti össze, a Submit rendezi és küldi el a szükséges állapotváltásokkal
+	RenderQueue m_renderQueue;
+	void QueueArenaGeometry(); // az aréna hálói (Suzanne, gömbök, a VBO-s fánk) két indirect hívással
+	void QueueParametricSurface(); // a vertex shaderben kiértékelt fánk
+	float ObjectDistance( std::size_t slot ) const; // a befoglaló gömb középpontjának távolsága a kamerától
+	void UploadParamSurfaceResolution(); // a fánk programjának felbontás uniformjai (csak változáskor)
 	bool HasCollidingSpheres(glm::vec3 newCoordinates);
+	void AppendSpheres(const std::vector<glm::vec3>& positions); // új gömbök a lista végére (rács, transzformációk, teleport sorrend)
+	void GenerateSpheres(const glm::vec3& boxMin, const glm::vec3& boxMax); // Poisson-disk kitöltés, egy lépésben hozzáadva
 
 	// Textúrázás, és változói
-	GLuint m_SuzanneTextureID = 0;
-	GLuint m_ParamSurfaceTextureID = 0;
+	// Suzanne, a gömbök és a fánk közös textúrája, egyszer betöltve. Suzanne és a gömbök egyetlen
+	// glMultiDrawElementsIndirect hívásban rajzolódnak, amihez csak egy textúra köthető.
+	GLuint m_woodTextureID = 0;
 
 	float m_cutoff = 0.0f;
 	int lightType = 0;
@@ -1,60 +1,189 @@
 #pragma once
-#include "GLUtils.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Dual.hpp"
+#include "MeshObject.hpp"
+#include "ThreadPool.hpp"
+
+// A fellet tpusnak csak a GetPos(u, v)-t ktelez megadnia. A normlis a GetNorm(u, v)-bl jn, ha van
+// (pl. analitikus kplet), klnben a GetPos-t sablonknt Dual paramterekkel kirtkelve kapott pontos
+// parcilis derivltak vektorilis szorzatbl. A textrakoordinta a GetTex(u, v), ha van, klnben (u, v).
+template <typename SurfT, typename = void>
+struct HasParamSurfNorm : std::false_type {};
+
+template <typename SurfT>
+struct HasParamSurfNorm<SurfT, std::void_t<decltype(std::declval<const SurfT&>().GetNorm(0.0f, 0.0f))>> : std::true_type {};
+
+template <typename SurfT, typename = void>
+struct HasParamSurfTex : std::false_type {};
 
 template <typename SurfT>
-[[nodiscard]] MeshObject<Vertex> GetParamSurfMesh(const SurfT& surf, const std::size_t N = 80, const std::size_t M = 40)
+struct HasParamSurfTex<SurfT, std::void_t<decltype(std::declval<const SurfT&>().GetTex(0.0f, 0.0f))>> : std::true_type {};
+
+template <typename SurfT>
+Vertex EvaluateParamSurf(const SurfT& surf, float u, float v)
 {
-	MeshObject<Vertex> outputMesh;
+	Vertex vertex;
+	if constexpr (HasParamSurfNorm<SurfT>::value)
+	{
+		vertex.position = surf.GetPos(u, v);
+		vertex.normal = surf.GetNorm(u, v);
+	}
+	else
+	{
+		// u, illetve v szerint derivlva; a pozci a dulis szmok rtk rsze
+		const DualVec3 dPdu = surf.GetPos(Dual(u, 1.0f), Dual(v));
+		const DualVec3 dPdv = surf.GetPos(Dual(u), Dual(v, 1.0f));
+		vertex.position = dPdu.value;
+		vertex.normal = glm::normalize(glm::cross(dPdu.derivative, dPdv.derivative));
+	}
+
+	if constexpr (HasParamSurfTex<SurfT>::value)
+		vertex.texcoord = surf.GetTex(u, v);
+	else
+		vertex.texcoord = glm::vec2(u, v);
+
+	return vertex;
+}
+
+// Opcionlis soronknti kirtkels: ha a fellet tpusnak van
+//     void GetRow(const float* u, std::size_t count, float v, Vertex* out) const
+// tagfggvnye, a GetParamSurfMesh egy v-hez tartoz teljes sort egyszerre kr tle. gy a csak v-tl fgg
+// rszeket elg soronknt egyszer kiszmolni, a bels (u szerinti) ciklus pedig vektorizlhat.
+// Ha nincs ilyen, az EvaluateParamSurf hvdik mintnknt.
+template <typename SurfT, typename = void>
+struct HasParamSurfRow : std::false_type {};
+
+template <typename SurfT>
+struct HasParamSurfRow<SurfT, std::void_t<decltype(std::declval<const SurfT&>().GetRow(
+	std::declval<const float*>(), std::size_t(0), 0.0f, std::declval<Vertex*>()))>> : std::true_type {};
+
+// ennyi cscs alatt a szlakra bonts tbbe kerl, mint amennyit nyer
+constexpr std::size_t PARAM_SURF_PARALLEL_MIN_VERTICES = 1 << 16;
+
+// A [0, rowCount) sorokat darabokra bontva dolgozza fel a pool-on (kis hlnl sorosan)
+template <typename RowFunc>
+void ForEachParamSurfRowRange(std::size_t rowCount, std::size_t vertexCount, ThreadPool& pool, RowFunc&& rows)
+{
+	if (vertexCount < PARAM_SURF_PARALLEL_MIN_VERTICES || pool.GetThreadCount() == 1)
+	{
+		rows(std::size_t(0), rowCount);
+		return;
+	}
+
+	// szlanknt nhny darab, hogy a lassabb szlak ne tartsk fel a tbbit
+	const std::size_t taskCount = std::min<std::size_t>(rowCount, 4 * pool.GetThreadCount());
+	const std::size_t rowsPerTask = (rowCount + taskCount - 1) / taskCount;
+	pool.ParallelFor((rowCount + rowsPerTask - 1) / rowsPerTask, [&](std::size_t task)
+	{
+		rows(task * rowsPerTask, std::min(rowCount, (task + 1) * rowsPerTask));
+	});
+}
+
+// A felletet az outputMesh-be rja; a vektorok kapacitst megtartja, gy ugyanazzal a mesh-sel
+// ismtelten hvva (pl. a felbonts csszka hzsakor) nem foglal jra, ha a hl nem n.
+// Nagy felbontsnl a cscs- s az indextmb sorait a pool szlai tltik ki; az eredmny ugyanaz.
+// TriangleStrip topolgival soronknt egy hromszgsvot ad (kb. harmannyi index, mint a lista).
+template <typename SurfT>
+void GetParamSurfMesh(const SurfT& surf, MeshObject<Vertex>& outputMesh, const std::size_t N = 80, const std::size_t M = 40,
+					  MeshTopology topology = MeshTopology::TriangleList, ThreadPool& pool = ThreadPool::Global())
+{
+	outputMesh.topology = topology;
 
 	// NxM darab ngyszggel kzeltjk a parametrikus felletnket => (N+1)x(M+1) pontban kell kirtkelni
 	outputMesh.vertexArray.resize((N + 1) * (M + 1));
 
-	for (std::size_t j = 0; j <= M; ++j)
+	// az u rtkek minden sorban ugyanazok
+	std::vector<float> us(N + 1);
+	for (std::size_t i = 0; i <= N; ++i) us[i] = i / (float)N;
+
+	ForEachParamSurfRowRange(M + 1, outputMesh.vertexArray.size(), pool, [&](std::size_t firstRow, std::size_t endRow)
 	{
-		for (std::size_t i = 0; i <= N; ++i)
+		for (std::size_t j = firstRow; j < endRow; ++j)
 		{
-			float u = i / (float)N;
 			float v = j / (float)M;
+			Vertex* row = outputMesh.vertexArray.data() + j * (N + 1);
 
-			std::size_t index = i + j * (N + 1);
-			outputMesh.vertexArray[index].position = surf.GetPos(u, v);
-			outputMesh.vertexArray[index].normal = surf.GetNorm(u, v);
-			outputMesh.vertexArray[index].texcoord = surf.GetTex(u, v);
+			if constexpr (HasParamSurfRow<SurfT>::value)
+			{
+				surf.GetRow(us.data(), N + 1, v, row);
+			}
+			else
+			{
+				for (std::size_t i = 0; i <= N; ++i) row[i] = EvaluateParamSurf(surf, us[i], v);
+			}
 		}
+	});
+
+	if (topology == MeshTopology::TriangleStrip)
+	{
+		// soronknt egy sv: C_0 A_0 C_1 A_1 ... C_N A_N (a jells lent), a sorok kztt PRIMITIVE_RESTART_INDEX.
+		// A krljrs a listval egyezik, csak a ngyszgek a msik tljuk mentn vannak kettvgva:
+		// (C_i, A_i, C_i+1) s (A_i, A_i+1, C_i+1).
+		const std::size_t stripLength = 2 * (N + 1);
+		outputMesh.indexArray.resize(M > 0 ? M * (stripLength + 1) - 1 : 0);
+
+		ForEachParamSurfRowRange(M, outputMesh.vertexArray.size(), pool, [&](std::size_t firstRow, std::size_t endRow)
+		{
+			for (std::size_t j = firstRow; j < endRow; ++j)
+			{
+				std::uint32_t* strip = outputMesh.indexArray.data() + j * (stripLength + 1);
+				for (std::size_t i = 0; i <= N; ++i)
+				{
+					strip[2 * i + 0] = static_cast<std::uint32_t>((i)+(j + 1) * (N + 1));
+					strip[2 * i + 1] = static_cast<std::uint32_t>((i)+(j) * (N + 1));
+				}
+				if (j + 1 < M) strip[stripLength] = PRIMITIVE_RESTART_INDEX;
+			}
+		});
+		return;
 	}
 
 	// indexpuffer adatai: NxM ngyszg = 2xNxM hromszg = hromszglista esetn 3x2xNxM index
 	outputMesh.indexArray.resize(3 * 2 * (N) * (M));
 
-	for (std::size_t j = 0; j < M; ++j)
+	ForEachParamSurfRowRange(M, outputMesh.vertexArray.size(), pool, [&](std::size_t firstRow, std::size_t endRow)
 	{
-		for (std::size_t i = 0; i < N; ++i)
+		for (std::size_t j = firstRow; j < endRow; ++j)
 		{
-			// minden ngyszgre csinljunk kett hromszget, amelyek a kvetkez 
-			// (i,j) indexeknl szletett (u_i, v_j) paramterrtkekhez tartoz
-			// pontokat ktik ssze:
-			// 
-			// (i,j+1) C-----D (i+1,j+1)
-			//         |\    |				A = p(u_i, v_j)
-			//         | \   |				B = p(u_{i+1}, v_j)
-			//         |  \  |				C = p(u_i, v_{j+1})
-			//         |   \ |				D = p(u_{i+1}, v_{j+1})
-			//         |    \|
-			//   (i,j) A-----B (i+1,j)
-			//
-			// - az (i,j)-hez tartz 1D-s index a VBO-ban: i+j*(N+1)
-			// - az (i,j)-hez tartz 1D-s index az IB-ben: i*6+j*6*N
-			//		(mert minden ngyszghz 2db hromszg = 6 index tartozik)
-			//
-			std::size_t index = i * 6 + j * (6 * N);
-			outputMesh.indexArray[index + 0] = static_cast<GLuint>((i)+(j) * (N + 1));
-			outputMesh.indexArray[index + 1] = static_cast<GLuint>((i + 1) + (j) * (N + 1));
-			outputMesh.indexArray[index + 2] = static_cast<GLuint>((i)+(j + 1) * (N + 1));
-			outputMesh.indexArray[index + 3] = static_cast<GLuint>((i + 1) + (j) * (N + 1));
-			outputMesh.indexArray[index + 4] = static_cast<GLuint>((i + 1) + (j + 1) * (N + 1));
-			outputMesh.indexArray[index + 5] = static_cast<GLuint>((i)+(j + 1) * (N + 1));
+			for (std::size_t i = 0; i < N; ++i)
+			{
+				// minden ngyszgre csinljunk kett hromszget, amelyek a kvetkez
+				// (i,j) indexeknl szletett (u_i, v_j) paramterrtkekhez tartoz
+				// pontokat ktik ssze:
+				//
+				// (i,j+1) C-----D (i+1,j+1)
+				//         |\    |				A = p(u_i, v_j)
+				//         | \   |				B = p(u_{i+1}, v_j)
+				//         |  \  |				C = p(u_i, v_{j+1})
+				//         |   \ |				D = p(u_{i+1}, v_{j+1})
+				//         |    \|
+				//   (i,j) A-----B (i+1,j)
+				//
+				// - az (i,j)-hez tartz 1D-s index a VBO-ban: i+j*(N+1)
+				// - az (i,j)-hez tartz 1D-s index az IB-ben: i*6+j*6*N
+				//		(mert minden ngyszghz 2db hromszg = 6 index tartozik)
+				//
+				std::size_t index = i * 6 + j * (6 * N);
+				outputMesh.indexArray[index + 0] = static_cast<std::uint32_t>((i)+(j) * (N + 1));
+				outputMesh.indexArray[index + 1] = static_cast<std::uint32_t>((i + 1) + (j) * (N + 1));
+				outputMesh.indexArray[index + 2] = static_cast<std::uint32_t>((i)+(j + 1) * (N + 1));
+				outputMesh.indexArray[index + 3] = static_cast<std::uint32_t>((i + 1) + (j) * (N + 1));
+				outputMesh.indexArray[index + 4] = static_cast<std::uint32_t>((i + 1) + (j + 1) * (N + 1));
+				outputMesh.indexArray[index + 5] = static_cast<std::uint32_t>((i)+(j + 1) * (N + 1));
+			}
 		}
-	}
+	});
+}
 
+template <typename SurfT>
+[[nodiscard]] MeshObject<Vertex> GetParamSurfMesh(const SurfT& surf, const std::size_t N = 80, const std::size_t M = 40,
+												  MeshTopology topology = MeshTopology::TriangleList, ThreadPool& pool = ThreadPool::Global())
+{
+	MeshObject<Vertex> outputMesh;
+	GetParamSurfMesh(surf, outputMesh, N, M, topology, pool);
 	return outputMesh;
-}
\ No newline at end of file
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "Dual.hpp"
+#include "MeshObject.hpp"
+
+// A tórusz és a gömb parametrikus egyenletei, GetParamSurfMesh-hez (ParametricSurfaceMesh.hpp).
+// A GetRow egy teljes sort (azonos v) számol ki ugyanazt adva, mint a skalár függvények,
+// csak a v-től függő tagokat soronként egyszer.
+
+// tórusz kirajzolásához szükséges adatok. Csak a pozíció van megadva, float-ra és Dual-ra is:
+// a normálist a GetParamSurfMesh a pozíció pontos parciális deriváltjaiból számolja (Dual.hpp).
+struct Torus
+{
+	float a, b;
+	Torus(float _a = 1.0f, float _b = 2.0f) : a(_a), b(_b) { }
+
+	template <typename T>
+	auto GetPos(T u, T v) const noexcept
+	{
+		using std::cos;
+		using std::sin;
+
+		u *= glm::two_pi<float>();
+		v *= -glm::two_pi<float>();
+		const T ring = a * cos(v) + b; // a cső középvonalától mért távolság a tengelytől
+		return MakeVec3(
+			ring * cos(u),
+			a * sin(v),
+			ring * sin(u)
+		);
+	}
+	glm::vec2 GetTex(float u, float v) const noexcept
+	{
+		return glm::vec2(u, v);
+	}
+
+	void GetRow(const float* u, std::size_t count, float v, Vertex* out) const noexcept
+	{
+		// a GetPos deriváltjai kézzel: U = 2pi*u, V = -2pi*v, R = a*cos(V) + b mellett
+		// dP/du = 2pi * (-R*sin(U), 0, R*cos(U)),  dP/dv = -2pi * (-a*sin(V)*cos(U), a*cos(V), -a*sin(V)*sin(U))
+		const float vAngle = v * -glm::two_pi<float>();
+		const float cv = cosf(vAngle), sv = sinf(vAngle);
+		const float ring = a * cv + b;
+		const float height = a * sv;
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const float uAngle = u[i] * glm::two_pi<float>();
+			const float cu = cosf(uAngle), su = sinf(uAngle);
+
+			const glm::vec3 du = glm::two_pi<float>() * glm::vec3(-ring * su, 0.0f, ring * cu);
+			const glm::vec3 dv = -glm::two_pi<float>() * glm::vec3(-a * sv * cu, a * cv, -a * sv * su);
+
+			out[i].position = glm::vec3(ring * cu, height, ring * su);
+			out[i].normal = glm::normalize(glm::cross(du, dv));
+			out[i].texcoord = glm::vec2(u[i], v);
+		}
+	}
+};
+
+// gömb parametrikus egyenlete
+struct Sphere
+{
+	float r;
+	Sphere(float _r = 1.f) : r(_r) { }
+
+	glm::vec3 GetPos(float u, float v) const noexcept
+	{
+		u *= glm::two_pi<float>();
+		v *= glm::pi<float>();
+
+		return glm::vec3(
+			r * sinf(v) * cosf(u),
+			r * cosf(v),
+			r * sinf(v) * sinf(u)
+		);
+	}
+	glm::vec3 GetNorm(float u, float v) const noexcept
+	{
+		u *= glm::two_pi<float>();
+		v *= glm::pi<float>();
+
+		return glm::vec3(
+			sinf(v) * cosf(u),
+			cosf(v),
+			sinf(v) * sinf(u)
+		);
+	}
+	glm::vec2 GetTex(float u, float v) const noexcept
+	{
+		return glm::vec2(u, v);
+	}
+
+	void GetRow(const float* u, std::size_t count, float v, Vertex* out) const noexcept
+	{
+		const float vAngle = v * glm::pi<float>();
+		const float sv = sinf(vAngle), cv = cosf(vAngle);
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const float uAngle = u[i] * glm::two_pi<float>();
+			const float cu = cosf(uAngle), su = sinf(uAngle);
+
+			out[i].position = glm::vec3(r * sv * cu, r * cv, r * sv * su);
+			out[i].normal = glm::vec3(sv * cu, cv, sv * su);
+			out[i].texcoord = glm::vec2(u[i], v);
+		}
+	}
+};
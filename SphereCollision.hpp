@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "VertexIndexMap.hpp"
+
+// megnézi, hogy a newPosition középpontú, sphereRadius sugarú gömb ütközik-e
+// valamelyik már elhelyezett (ugyanekkora sugarú) gömbbel
+inline bool HasCollidingSpheres(const std::vector<glm::vec3>& spherePositions, glm::vec3 newPositions, float sphereRadius) {
+	// végigiterálunk az összes eddig pozíción, megnézzük, hogy
+	// bármelyikkel ütküzik-e az újonnan felvenni kívánt gömbünk,
+	// erre az alábbi algoritmust használjuk
+	for (auto sphere : spherePositions) {
+		float distance = std::sqrt(
+			std::pow(newPositions.x - sphere.x, 2) +
+			std::pow(newPositions.y - sphere.y, 2) +
+			std::pow(newPositions.z - sphere.z, 2)
+		);
+
+		if (distance <= 2 * sphereRadius) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Egyenletes rács a gömbök ütközésvizsgálatához: a cellákat a koordinátáik szerint hasítjuk
+// (csak a nem üres cellák foglalnak helyet), egy cellában a gömbök láncolt listában vannak.
+// Beszúrás és lekérdezés várhatóan O(1), ha a cellaméret a gömbök átmérőjének nagyságrendjébe esik
+// (CMyApp-ban 2 * m_sphereRadius). A sugár gömbönként eltérhet; a lekérdezés a legnagyobb beszúrt
+// sugárral bővített környezet celláit nézi végig.
+class SphereGrid
+{
+public:
+	explicit SphereGrid( float cellSize ) : m_cellSize( cellSize ), m_invCellSize( 1.0f / cellSize ) {}
+
+	// legalább sphereCount gömb fér el újrafoglalás nélkül
+	void Reserve( std::size_t sphereCount )
+	{
+		m_spheres.reserve( sphereCount );
+		m_next.reserve( sphereCount );
+		m_cellHeads.reserve( sphereCount );
+		m_cells.Reserve( sphereCount );
+	}
+
+	void Insert( const glm::vec3& center, float radius )
+	{
+		const std::uint32_t sphereIndex = static_cast<std::uint32_t>( m_spheres.size() );
+		const auto [ cell, isNewCell ] = m_cells.TryEmplace( CellKey( CellOf( center ) ), static_cast<std::uint32_t>( m_cellHeads.size() ) );
+		if ( isNewCell ) m_cellHeads.push_back( NONE );
+
+		m_spheres.emplace_back( center, radius );
+		m_next.push_back( m_cellHeads[ cell ] );
+		m_cellHeads[ cell ] = sphereIndex;
+		m_maxRadius = std::max( m_maxRadius, radius );
+
+		const glm::ivec3 c = CellOf( center );
+		m_occupiedMin = sphereIndex == 0 ? c : glm::ivec3( std::min( m_occupiedMin.x, c.x ), std::min( m_occupiedMin.y, c.y ), std::min( m_occupiedMin.z, c.z ) );
+		m_occupiedMax = sphereIndex == 0 ? c : glm::ivec3( std::max( m_occupiedMax.x, c.x ), std::max( m_occupiedMax.y, c.y ), std::max( m_occupiedMax.z, c.z ) );
+	}
+
+	// egyforma sugarú gömbök egyszerre (pl. egy generált színtér), ütközésvizsgálat nélkül
+	void Insert( const std::vector<glm::vec3>& centers, float radius )
+	{
+		Reserve( m_spheres.size() + centers.size() );
+		for ( const glm::vec3& center : centers ) Insert( center, radius );
+	}
+
+	// ütközik-e (vagy érintkezik-e) a center középpontú, radius sugarú gömb valamelyik beszúrttal
+	bool Overlaps( const glm::vec3& center, float radius ) const
+	{
+		// néhány gömbnél gyorsabb mindet megnézni, mint a szomszédos cellákat kikeresni
+		if ( m_spheres.size() <= LINEAR_SEARCH_LIMIT )
+		{
+			for ( const glm::vec4& sphere : m_spheres )
+			{
+				if ( Touches( center, radius, sphere ) ) return true;
+			}
+			return false;
+		}
+
+		// a lefedett cellák, a foglalt cellák befoglaló dobozára vágva
+		const float reach = radius + m_maxRadius;
+		const glm::ivec3 lo = CellOf( center - reach );
+		const glm::ivec3 hi = CellOf( center + reach );
+		const glm::ivec3 cellMin( std::max( lo.x, m_occupiedMin.x ), std::max( lo.y, m_occupiedMin.y ), std::max( lo.z, m_occupiedMin.z ) );
+		const glm::ivec3 cellMax( std::min( hi.x, m_occupiedMax.x ), std::min( hi.y, m_occupiedMax.y ), std::min( hi.z, m_occupiedMax.z ) );
+
+		for ( int z = cellMin.z; z <= cellMax.z; ++z )
+		for ( int y = cellMin.y; y <= cellMax.y; ++y )
+		for ( int x = cellMin.x; x <= cellMax.x; ++x )
+		{
+			const std::uint32_t cell = m_cells.Find( CellKey( glm::ivec3( x, y, z ) ) );
+			if ( cell == VertexIndexMap::EMPTY ) continue;
+
+			for ( std::uint32_t i = m_cellHeads[ cell ]; i != NONE; i = m_next[ i ] )
+			{
+				if ( Touches( center, radius, m_spheres[ i ] ) ) return true;
+			}
+		}
+
+		return false;
+	}
+
+	std::size_t Size() const noexcept { return m_spheres.size(); }
+	float CellSize() const noexcept { return m_cellSize; }
+
+	void Clear() noexcept
+	{
+		m_spheres.clear();
+		m_next.clear();
+		m_cellHeads.clear();
+		m_cells.Clear();
+		m_maxRadius = 0.0f;
+	}
+
+private:
+	static constexpr std::uint32_t NONE = ~std::uint32_t( 0 ); // lista vége
+	static constexpr std::size_t LINEAR_SEARCH_LIMIT = 32;
+
+	// négyzetes távolsággal, gyökvonás nélkül; az érintkezés is ütközés, mint a HasCollidingSpheres-ben
+	static bool Touches( const glm::vec3& center, float radius, const glm::vec4& sphere ) noexcept
+	{
+		const glm::vec3 d = center - glm::vec3( sphere );
+		const float minDistance = radius + sphere.w;
+		return glm::dot( d, d ) <= minDistance * minDistance;
+	}
+
+	glm::ivec3 CellOf( const glm::vec3& p ) const noexcept
+	{
+		return glm::ivec3( glm::floor( p * m_invCellSize ) );
+	}
+
+	// a cella koordinátái a 96 bites IndexedVert kulcsba csomagolva
+	static IndexedVert CellKey( const glm::ivec3& cell ) noexcept
+	{
+		return IndexedVert{ static_cast<std::uint32_t>( cell.x ), static_cast<std::uint32_t>( cell.y ), static_cast<std::uint32_t>( cell.z ) };
+	}
+
+	float m_cellSize;
+	float m_invCellSize;
+	float m_maxRadius = 0.0f;
+	glm::ivec3 m_occupiedMin{ 0, 0, 0 }; // a foglalt cellák befoglaló doboza
+	glm::ivec3 m_occupiedMax{ 0, 0, 0 };
+
+	std::vector<glm::vec4>     m_spheres;   // középpont és sugár (w)
+	std::vector<std::uint32_t> m_next;      // a cella listájában a következő gömb, vagy NONE
+	std::vector<std::uint32_t> m_cellHeads; // cellánként a lista első gömbje
+	VertexIndexMap             m_cells;     // cella koordináták -> m_cellHeads index
+};
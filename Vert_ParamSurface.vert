@@ -0,0 +1,87 @@
+#version 430
+
+// Attribútum nélküli tórusz: a csúcsot a gl_VertexID-ből számoljuk ki, VBO és IBO nélkül.
+// A csúcsok sorrendje a GetParamSurfMesh (ParametricSurfaceMesh.hpp) index pufferéé, négyszögenként 6 csúcs:
+//
+// (i,j+1) C-----D (i+1,j+1)
+//         |\    |
+//         | \   |      ABC, BDC
+//         |  \  |
+//   (i,j) A-----B (i+1,j)
+
+// a pipeline-ban tovább adandó értékek
+out vec3 vs_out_pos;
+out vec3 vs_out_norm;
+out vec2 vs_out_tex;
+
+// képkockánként egyszer feltöltött adatok (FrameUniforms, MyApp.h)
+layout( std140, binding = 0 ) uniform FrameData
+{
+	mat4 viewProj;
+	vec4 cameraPos;
+};
+
+// objektumonkénti transzformációk (ObjectTransform, MyApp.h)
+struct ObjectTransform
+{
+	mat4 world;
+	mat4 worldIT;
+};
+
+layout( std430, binding = 0 ) readonly buffer ObjectTransforms
+{
+	ObjectTransform objects[];
+};
+
+uniform uint  objectIndex;   // a felület helye az ObjectTransforms tömbben
+uniform uint  resolutionN;   // négyszögek száma u irányban
+uniform uint  resolutionM;   // és v irányban
+uniform float torusA;        // Torus::a, a cső sugara
+uniform float torusB;        // Torus::b, a cső középvonalának sugara
+
+const float TWO_PI = 6.28318530718;
+
+// Torus::GetPos (ParametricSurfaces.hpp)
+vec3 GetPos( float u, float v )
+{
+	u *= TWO_PI;
+	v *= -TWO_PI;
+	return vec3( ( torusA * cos( v ) + torusB ) * cos( u ),
+				   torusA * sin( v ),
+				 ( torusA * cos( v ) + torusB ) * sin( u ) );
+}
+
+// a GetPos pontos parciális deriváltjainak vektoriális szorzata, mint a CPU-n (Torus::GetRow)
+vec3 GetNorm( float u, float v )
+{
+	u *= TWO_PI;
+	v *= -TWO_PI;
+	float ring = torusA * cos( v ) + torusB;
+	vec3 du = TWO_PI * vec3( -ring * sin( u ), 0, ring * cos( u ) );
+	vec3 dv = -TWO_PI * vec3( -torusA * sin( v ) * cos( u ), torusA * cos( v ), -torusA * sin( v ) * sin( u ) );
+	return normalize( cross( du, dv ) );
+}
+
+// a négyszög 6 csúcsának (i, j) eltolása: A B C B D C
+const uvec2 QUAD_CORNERS[ 6 ] = uvec2[ 6 ]( uvec2( 0, 0 ), uvec2( 1, 0 ), uvec2( 0, 1 ),
+											uvec2( 1, 0 ), uvec2( 1, 1 ), uvec2( 0, 1 ) );
+
+void main()
+{
+	uint quad = uint( gl_VertexID ) / 6u;
+	uvec2 ij = uvec2( quad % resolutionN, quad / resolutionN ) + QUAD_CORNERS[ uint( gl_VertexID ) % 6u ];
+
+	// a CPU-s változattal azonos módon: i / (float)N
+	float u = float( ij.x ) / float( resolutionN );
+	float v = float( ij.y ) / float( resolutionM );
+
+	ObjectTransform object = objects[ objectIndex ];
+
+	vec4 worldPos = object.world * vec4( GetPos( u, v ), 1 );
+
+	gl_Position = viewProj * worldPos;
+	vs_out_pos  = worldPos.xyz;
+	vs_out_norm = (object.worldIT * vec4( GetNorm( u, v ), 0 )).xyz;
+
+	vs_out_tex = vec2( u, v );
+}
@@ -1,25 +1,56 @@
 #version 430
 
-// VBO-ból érkező változók
-layout( location = 0 ) in vec3 vs_in_pos;
-layout( location = 1 ) in vec3 vs_in_norm;
+// VBO-ból érkező változók (tömörített csúcsok, lásd VertexPacked)
+layout( location = 0 ) in vec3 vs_in_pos;  // [-1, 1]-be normalizálva, a world mátrix skáláz vissza
+layout( location = 1 ) in vec2 vs_in_norm; // oktaéder kódolású normális
 layout( location = 2 ) in vec2 vs_in_tex;
+// az objektum sorszáma az ObjectTransforms tömbben (példányonként lép, a rajzolás base instance-e tolja el)
+layout( location = 3 ) in uint vs_in_objectIndex;
 
 // a pipeline-ban tovább adandó értékek
 out vec3 vs_out_pos;
 out vec3 vs_out_norm;
 out vec2 vs_out_tex;
 
-// shader külső paraméterei - most a három transzformációs mátrixot külön-külön vesszük át
-uniform mat4 world;
-uniform mat4 worldIT;
-uniform mat4 viewProj;
+// képkockánként egyszer feltöltött adatok (FrameUniforms, MyApp.h)
+layout( std140, binding = 0 ) uniform FrameData
+{
+	mat4 viewProj;
+	vec4 cameraPos;
+};
+
+// objektumonkénti transzformációk (ObjectTransform, MyApp.h), csak változáskor töltjük fel
+struct ObjectTransform
+{
+	mat4 world;
+	mat4 worldIT;
+};
+
+layout( std430, binding = 0 ) readonly buffer ObjectTransforms
+{
+	ObjectTransform objects[];
+};
+
+// DecodeOctahedral() megfelelője (MeshPacking.cpp)
+vec3 DecodeOctahedral( vec2 e )
+{
+	vec3 n = vec3( e, 1.0 - abs( e.x ) - abs( e.y ) );
+	float t = max( -n.z, 0.0 );
+	n.xy += vec2( n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t );
+	return normalize( n );
+}
 
 void main()
 {
-	gl_Position = viewProj * world * vec4( vs_in_pos, 1 );
-	vs_out_pos  = (world   * vec4(vs_in_pos,  1)).xyz;
-	vs_out_norm = (worldIT * vec4(vs_in_norm, 0)).xyz;
+	vec3 norm = DecodeOctahedral( vs_in_norm );
+
+	ObjectTransform object = objects[ vs_in_objectIndex ];
+
+	vec4 worldPos = object.world * vec4( vs_in_pos, 1 );
+
+	gl_Position = viewProj * worldPos;
+	vs_out_pos  = worldPos.xyz;
+	vs_out_norm = (object.worldIT * vec4(norm, 0)).xyz;
 
 	vs_out_tex = vs_in_tex;
 }
\ No newline at end of file
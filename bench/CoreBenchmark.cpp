@@ -0,0 +1,1032 @@
+// Headless benchmark a program GL-független CPU oldali részeire:
+// ObjParser::parse, csúcs összevonás (VertexIndexMap), OptimizeMesh, PackMesh, GetParamSurfMesh<Torus/Sphere>, HasCollidingSpheres, SphereGrid, GeneratePoissonDisk, CullSpheres,
+// RangeAllocator, RadixSort, ObjParser::triangulatePolygon és invert_image_RGBA.
+//
+// Használat: teleporting_bench [--quick] [--large] [--min-time <sec>] [<obj fájl>]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h> // _aligned_malloc
+#endif
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "ObjParser.h"
+#include "ImageUtils.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshPacking.hpp"
+#include "ParametricSurfaceMesh.hpp"
+#include "ParametricSurfaces.hpp"
+#include "SphereCollision.hpp"
+#include "PoissonDisk.hpp"
+#include "RadixSort.hpp"
+#include "RangeAllocator.hpp"
+#include "Frustum.hpp"
+#include "ThreadPool.hpp"
+#include "VertexIndexMap.hpp"
+
+#ifndef TELEPORTING_ASSETS_DIR
+#define TELEPORTING_ASSETS_DIR "Assets"
+#endif
+
+//
+// Foglalások számlálása: a globális new/delete-et cseréljük le
+//
+
+static std::atomic<std::uint64_t> g_allocCount{ 0 };
+static std::atomic<std::uint64_t> g_allocBytes{ 0 };
+
+void* operator new( std::size_t size )
+{
+	g_allocCount.fetch_add( 1, std::memory_order_relaxed );
+	g_allocBytes.fetch_add( size, std::memory_order_relaxed );
+	if ( void* ptr = std::malloc( size ? size : 1 ) ) return ptr;
+	throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size ) { return operator new( size ); }
+
+// A túligazított foglalások (alignas > __STDCPP_DEFAULT_NEW_ALIGNMENT__) is számítanak
+void* operator new( std::size_t size, std::align_val_t alignment )
+{
+	g_allocCount.fetch_add( 1, std::memory_order_relaxed );
+	g_allocBytes.fetch_add( size, std::memory_order_relaxed );
+
+	const std::size_t align = static_cast<std::size_t>( alignment );
+#ifdef _MSC_VER
+	if ( void* ptr = _aligned_malloc( size ? size : 1, align ) ) return ptr;
+#else
+	// az aligned_alloc mérete az igazítás többszöröse kell legyen
+	if ( void* ptr = std::aligned_alloc( align, ( ( size ? size : 1 ) + align - 1 ) & ~( align - 1 ) ) ) return ptr;
+#endif
+	throw std::bad_alloc();
+}
+
+void* operator new[]( std::size_t size, std::align_val_t alignment ) { return operator new( size, alignment ); }
+
+// A GCC a new kifejezésekbe inline-olt delete-ben a malloc-ot nem látja, csak a free-t: a cserélt párosra téves a figyelmeztetés
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete( void* ptr ) noexcept { std::free( ptr ); }
+void operator delete( void* ptr, std::align_val_t ) noexcept
+{
+#ifdef _MSC_VER
+	_aligned_free( ptr );
+#else
+	std::free( ptr );
+#endif
+}
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+
+// a többi delete forma a fenti kettőre vezet
+void operator delete[]( void* ptr ) noexcept { operator delete( ptr ); }
+void operator delete( void* ptr, std::size_t ) noexcept { operator delete( ptr ); }
+void operator delete[]( void* ptr, std::size_t ) noexcept { operator delete( ptr ); }
+void operator delete[]( void* ptr, std::align_val_t alignment ) noexcept { operator delete( ptr, alignment ); }
+void operator delete( void* ptr, std::size_t, std::align_val_t alignment ) noexcept { operator delete( ptr, alignment ); }
+void operator delete[]( void* ptr, std::size_t, std::align_val_t alignment ) noexcept { operator delete( ptr, alignment ); }
+
+//
+// Mérés
+//
+
+static volatile std::uint64_t g_sink = 0; // hogy a fordító ne dobja el a mért munkát
+
+struct BenchConfig
+{
+	double minTimeSec = 0.5;
+	bool   quick = false;
+	bool   large = false;
+	std::filesystem::path objPath = std::filesystem::path( TELEPORTING_ASSETS_DIR ) / "Suzanne.obj";
+};
+
+struct BenchResult
+{
+	double        bestSec = 0.0;  // a legjobb iteráció ideje
+	std::uint64_t allocs = 0;     // foglalások száma egy iterációban
+	std::uint64_t allocBytes = 0; // foglalt bájtok egy iterációban
+	int           iterations = 0;
+};
+
+template <typename Func>
+static BenchResult Measure( const BenchConfig& config, Func&& func )
+{
+	using Clock = std::chrono::steady_clock;
+
+	BenchResult result;
+	result.bestSec = 1e30;
+
+	func(); // bemelegítés (page cache, allokátor)
+
+	const Clock::time_point start = Clock::now();
+	do
+	{
+		const std::uint64_t allocCount = g_allocCount.load( std::memory_order_relaxed );
+		const std::uint64_t allocBytes = g_allocBytes.load( std::memory_order_relaxed );
+
+		const Clock::time_point iterStart = Clock::now();
+		func();
+		const double iterSec = std::chrono::duration<double>( Clock::now() - iterStart ).count();
+
+		result.allocs = g_allocCount.load( std::memory_order_relaxed ) - allocCount;
+		result.allocBytes = g_allocBytes.load( std::memory_order_relaxed ) - allocBytes;
+		result.bestSec = std::min( result.bestSec, iterSec );
+		result.iterations++;
+	} while ( std::chrono::duration<double>( Clock::now() - start ).count() < config.minTimeSec && result.iterations < 1000 );
+
+	return result;
+}
+
+// amount/unit: egy iterációban feldolgozott mennyiség és annak mértékegysége (pl. 1.3, "MB")
+static void Report( const std::string& name, const BenchResult& result,
+					double amount1, const char* unit1,
+					double amount2 = 0.0, const char* unit2 = nullptr )
+{
+	std::printf( "%-44s %10.3f ms %12.2f %-9s", name.c_str(), result.bestSec * 1e3, amount1 / result.bestSec, unit1 );
+	if ( unit2 != nullptr )
+		std::printf( " %14.2f %-11s", amount2 / result.bestSec, unit2 );
+	else
+		std::printf( " %26s", "" );
+	std::printf( " %10llu allocs %10.2f MB\n", static_cast<unsigned long long>( result.allocs ), result.allocBytes / 1e6 );
+}
+
+//
+// Szintetikus bemenetek
+//
+
+// sideQuads x sideQuads négyszögből álló hullámos rács OBJ formátumban, v/vt/vn-nel
+static std::string GenerateGridObj( int sideQuads, bool quads )
+{
+	std::string obj;
+	obj.reserve( static_cast<std::size_t>( sideQuads + 1 ) * ( sideQuads + 1 ) * 100 + static_cast<std::size_t>( sideQuads ) * sideQuads * 60 );
+	obj += "# teleporting_bench synthetic grid\no Grid\n";
+
+	char line[ 256 ];
+	const int side = sideQuads + 1;
+	for ( int j = 0; j < side; ++j )
+	{
+		for ( int i = 0; i < side; ++i )
+		{
+			const float x = i / float( sideQuads ) * 2.0f - 1.0f;
+			const float z = j / float( sideQuads ) * 2.0f - 1.0f;
+			std::snprintf( line, sizeof( line ), "v %.6f %.6f %.6f\n", x, 0.1f * std::sin( 7.0f * x ) * std::cos( 5.0f * z ), z );
+			obj += line;
+		}
+	}
+	for ( int j = 0; j < side; ++j )
+	{
+		for ( int i = 0; i < side; ++i )
+		{
+			std::snprintf( line, sizeof( line ), "vt %.6f %.6f\n", i / float( sideQuads ), j / float( sideQuads ) );
+			obj += line;
+		}
+	}
+	obj += "vn 0.0000 1.0000 0.0000\n";
+
+	for ( int j = 0; j < sideQuads; ++j )
+	{
+		for ( int i = 0; i < sideQuads; ++i )
+		{
+			const int a = 1 + i + j * side;
+			const int b = a + 1;
+			const int c = a + side;
+			const int d = c + 1;
+			if ( quads )
+				std::snprintf( line, sizeof( line ), "f %d/%d/1 %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, c, c, d, d, b, b );
+			else
+				std::snprintf( line, sizeof( line ), "f %d/%d/1 %d/%d/1 %d/%d/1\nf %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, c, c, d, d, a, a, d, d, b, b );
+			obj += line;
+		}
+	}
+
+	return obj;
+}
+
+static std::filesystem::path WriteTempFile( const std::string& name, const std::string& content )
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::ofstream strm( path, std::ios::binary );
+	strm.write( content.data(), static_cast<std::streamsize>( content.size() ) );
+	return path;
+}
+
+// n oldalú, csillag alakú (konkáv) sokszög, CCW
+static std::vector<glm::vec2> GenerateStarPolygon( int n )
+{
+	std::vector<glm::vec2> polygon( n );
+	for ( int i = 0; i < n; ++i )
+	{
+		const float angle = i / float( n ) * glm::two_pi<float>();
+		const float radius = ( i % 2 == 0 ) ? 1.0f : 0.6f;
+		polygon[ i ] = glm::vec2( radius * std::cos( angle ), radius * std::sin( angle ) );
+	}
+	return polygon;
+}
+
+//
+// Benchmarkok
+//
+
+static bool g_mismatch = false; // két, azonos eredményt adó változat (pl. párhuzamos és soros OBJ betöltés) eltért
+
+static bool SameMesh( const ObjParser::Mesh& a, const ObjParser::Mesh& b )
+{
+	return a.vertexArray.size() == b.vertexArray.size()
+		&& a.indexArray == b.indexArray
+		&& std::memcmp( a.vertexArray.data(), b.vertexArray.data(), a.vertexArray.size() * sizeof( Vertex ) ) == 0;
+}
+
+static void BenchObjFile( const BenchConfig& config, const std::string& name, const std::filesystem::path& path )
+{
+	std::error_code ec;
+	const std::uintmax_t fileSize = std::filesystem::file_size( path, ec );
+	if ( ec )
+	{
+		std::printf( "%-44s skipped: cannot open %s\n", name.c_str(), path.string().c_str() );
+		return;
+	}
+
+	std::size_t triangles = 0;
+	BenchResult result = Measure( config, [ & ]()
+	{
+		ObjParser::Mesh mesh = ObjParser::parse( path );
+		triangles = mesh.indexArray.size() / 3;
+		g_sink = g_sink + mesh.vertexArray.size();
+	} );
+
+	Report( name, result, fileSize / 1e6, "MB/s", double( triangles ), "tris/s" );
+
+	result = Measure( config, [ & ]()
+	{
+		ObjParser::Mesh mesh = ObjParser::parseParallel( path );
+		g_sink = g_sink + mesh.vertexArray.size();
+	} );
+
+	Report( name + " (parallel)", result, fileSize / 1e6, "MB/s", double( triangles ), "tris/s" );
+
+	// bináris cache: az első betöltés megírja, a mért (meleg) betöltések csak leképzik
+	std::filesystem::path cachedObjPath = std::filesystem::temp_directory_path() / ( "teleporting_bench_cached_" + path.filename().string() );
+	std::filesystem::copy_file( path, cachedObjPath, std::filesystem::copy_options::overwrite_existing, ec );
+	if ( !ec )
+	{
+		std::uint64_t checksum = 0;
+		result = Measure( config, [ & ]()
+		{
+			ObjParser::CachedMesh mesh = ObjParser::parseCached( cachedObjPath );
+			const MeshView<Vertex> view = mesh.View();
+			checksum = 0;
+			for ( std::size_t i = 0; i < view.indexCount; i += 1024 ) checksum += view.indices[ i ]; // legalább laponként érintsük
+			g_sink = g_sink + view.vertexCount + checksum;
+		} );
+
+		// a meleg betöltés a cache fájlt képzi le, nem az OBJ szöveget dolgozza fel: az átvitel a cache fájl méretével számolva
+		const std::uintmax_t cacheSize = std::filesystem::file_size( ObjParser::cachePath( cachedObjPath ), ec );
+		Report( name + " (cached)", result, ec ? 0.0 : cacheSize / 1e6, "cacheMB/s" );
+
+		std::filesystem::remove( ObjParser::cachePath( cachedObjPath ), ec );
+		std::filesystem::remove( cachedObjPath, ec );
+	}
+
+	// 8 szálra bontva akkor is ellenőrizzük a darabolást, ha a gépen kevesebb mag van
+	if ( !SameMesh( ObjParser::parse( path ), ObjParser::parseParallel( path, 8 ) ) )
+	{
+		std::printf( "%-44s MISMATCH: parseParallel differs from parse\n", name.c_str() );
+		g_mismatch = true;
+	}
+}
+
+static void BenchObjParser( const BenchConfig& config )
+{
+	BenchObjFile( config, "ObjParser::parse " + config.objPath.filename().string(), config.objPath );
+
+	std::vector<int> gridSizes = config.quick ? std::vector<int>{ 128 } : std::vector<int>{ 128, 512, 1024 };
+	if ( config.large ) gridSizes.push_back( 2048 );
+
+	for ( int gridSize : gridSizes )
+	{
+		for ( bool quads : { false, true } )
+		{
+			const std::string fileName = "teleporting_bench_grid_" + std::to_string( gridSize ) + ( quads ? "_quad" : "_tri" ) + ".obj";
+			const std::filesystem::path path = WriteTempFile( fileName, GenerateGridObj( gridSize, quads ) );
+
+			BenchObjFile( config, "ObjParser::parse grid " + std::to_string( gridSize ) + "^2 " + ( quads ? "quads" : "tris" ), path );
+
+			std::error_code ec;
+			std::filesystem::remove( path, ec );
+		}
+	}
+}
+
+// A GetRow-t elrejtő burok: így a GetParamSurfMesh a mintánkénti ágat futtatja (GetNorm vagy duális számok)
+template <typename SurfT>
+struct ScalarOnlySurface : SurfT
+{
+	explicit ScalarOnlySurface( const SurfT& surf ) : SurfT( surf ) { }
+
+	void GetRow() const = delete;
+};
+
+// A tórusz régi, véges differenciás normálisa (négy további GetPos kiértékelés), a duális számokhoz viszonyítva
+struct FiniteDifferenceTorus : Torus
+{
+	glm::vec3 GetNorm( float u, float v ) const noexcept
+	{
+		const glm::vec3 du = GetPos( u + 0.01f, v ) - GetPos( u - 0.01f, v );
+		const glm::vec3 dv = GetPos( u, v + 0.01f ) - GetPos( u, v - 0.01f );
+		return glm::normalize( glm::cross( du, dv ) );
+	}
+};
+
+template <typename SurfT>
+static void BenchParamSurf( const BenchConfig& config, const std::string& name, const SurfT& surf, std::size_t N, std::size_t M )
+{
+	const std::string fullName = name + " " + std::to_string( N ) + "x" + std::to_string( M );
+	const double vertexBytes = double( ( N + 1 ) * ( M + 1 ) * sizeof( Vertex ) + 6 * N * M * sizeof( std::uint32_t ) );
+
+	BenchResult result = Measure( config, [ & ]()
+	{
+		MeshObject<Vertex> mesh = GetParamSurfMesh( surf, N, M );
+		g_sink = g_sink + mesh.indexArray.size();
+	} );
+	Report( fullName, result, 2.0 * N * M, "tris/s", vertexBytes / 1e6, "MB/s" );
+
+	// az eredeti, mintánkénti és egyszálú kiértékelés az összehasonlításhoz
+	ThreadPool serialPool( 1 );
+	result = Measure( config, [ & ]()
+	{
+		MeshObject<Vertex> mesh = GetParamSurfMesh( ScalarOnlySurface<SurfT>( surf ), N, M, MeshTopology::TriangleList, serialPool );
+		g_sink = g_sink + mesh.indexArray.size();
+	} );
+	Report( fullName + " (scalar)", result, 2.0 * N * M, "tris/s", vertexBytes / 1e6, "MB/s" );
+}
+
+// A primitive restart-tal elválasztott háromszögsávok háromszögei, a GL körüljárása szerint
+// (a páratlan sorszámúaknál az első két csúcs felcserélve)
+template <typename TriangleFunc>
+static void ForEachStripTriangle( const std::vector<std::uint32_t>& indices, TriangleFunc&& triangle )
+{
+	std::size_t stripStart = 0;
+	for ( std::size_t i = 0; i <= indices.size(); ++i )
+	{
+		if ( i < indices.size() && indices[ i ] != PRIMITIVE_RESTART_INDEX ) continue;
+
+		for ( std::size_t k = stripStart; k + 2 < i; ++k )
+		{
+			if ( ( k - stripStart ) % 2 == 0 ) triangle( indices[ k ], indices[ k + 1 ], indices[ k + 2 ] );
+			else                               triangle( indices[ k + 1 ], indices[ k ], indices[ k + 2 ] );
+		}
+		stripStart = i + 1;
+	}
+}
+
+// A GetRow-s és a skalár kiértékelés csak a fordító kifejezés-összevonásaiban (FMA) térhet el, a soros és a
+// párhuzamos kitöltés pedig bitre egyezik. A 8 szálas pool-lal akkor is ellenőrizzük a sorok szétosztását,
+// ha a gépen kevesebb mag van.
+template <typename SurfT>
+static void CheckParamSurf( const std::string& name, const SurfT& surf, std::size_t N, std::size_t M )
+{
+	ThreadPool serialPool( 1 ), parallelPool( 8 );
+	const MeshObject<Vertex> scalar = GetParamSurfMesh( ScalarOnlySurface<SurfT>( surf ), N, M, MeshTopology::TriangleList, serialPool );
+	const MeshObject<Vertex> serial = GetParamSurfMesh( surf, N, M, MeshTopology::TriangleList, serialPool );
+	const MeshObject<Vertex> parallel = GetParamSurfMesh( surf, N, M, MeshTopology::TriangleList, parallelPool );
+
+	if ( serial.indexArray != parallel.indexArray || serial.indexArray != scalar.indexArray
+		|| std::memcmp( serial.vertexArray.data(), parallel.vertexArray.data(), serial.vertexArray.size() * sizeof( Vertex ) ) != 0 )
+	{
+		std::printf( "  MISMATCH: %s: parallel GetParamSurfMesh differs from the serial one\n", name.c_str() );
+		g_mismatch = true;
+	}
+
+	// sávok: ugyanazok a négyszögek, két-két háromszöggel, mindegyik a listáéval azonos (u, v)-beli körüljárással
+	const MeshObject<Vertex> strips = GetParamSurfMesh( surf, N, M, MeshTopology::TriangleStrip, parallelPool );
+	std::size_t frontFacing = 0, backFacing = 0;
+	ForEachStripTriangle( strips.indexArray, [ & ]( std::uint32_t a, std::uint32_t b, std::uint32_t c )
+	{
+		const glm::vec2 ab = strips.vertexArray[ b ].texcoord - strips.vertexArray[ a ].texcoord;
+		const glm::vec2 ac = strips.vertexArray[ c ].texcoord - strips.vertexArray[ a ].texcoord;
+		( ab.x * ac.y - ab.y * ac.x > 0.0f ? frontFacing : backFacing )++;
+	} );
+	if ( strips.indexArray != GetParamSurfMesh( surf, N, M, MeshTopology::TriangleStrip, serialPool ).indexArray
+		|| frontFacing != 2 * N * M || backFacing != 0 )
+	{
+		std::printf( "  MISMATCH: %s: triangle strips do not cover the grid like the triangle list\n", name.c_str() );
+		g_mismatch = true;
+	}
+
+	float maxError = 0.0f;
+	for ( std::size_t i = 0; i < scalar.vertexArray.size(); ++i )
+	{
+		const Vertex& a = scalar.vertexArray[ i ];
+		const Vertex& b = serial.vertexArray[ i ];
+		maxError = std::max( { maxError, glm::length( a.position - b.position ), glm::length( a.normal - b.normal ), glm::length( a.texcoord - b.texcoord ) } );
+	}
+	if ( maxError > 1e-4f )
+	{
+		std::printf( "  MISMATCH: %s: GetRow differs from the scalar API by %g\n", name.c_str(), maxError );
+		g_mismatch = true;
+	}
+}
+
+static void BenchParamSurfaces( const BenchConfig& config )
+{
+	CheckParamSurf( "GetParamSurfMesh<Torus>", Torus(), 400, 300 );
+	CheckParamSurf( "GetParamSurfMesh<Sphere>", Sphere( 2.0f ), 400, 300 );
+
+	BenchParamSurf( config, "GetParamSurfMesh<Torus>", Torus(), 50, 50 );
+	BenchParamSurf( config, "GetParamSurfMesh<Torus>", Torus(), 100, 100 );
+	BenchParamSurf( config, "GetParamSurfMesh<Sphere>", Sphere( 2.0f ), 80, 40 );
+	BenchParamSurf( config, "GetParamSurfMesh<FiniteDiffTorus>", FiniteDifferenceTorus(), 100, 100 );
+
+	// a duális számokkal kapott normális és a régi, véges differenciás közelítés csak O(0.01^2)-nel térhet el
+	{
+		ThreadPool serialPool( 1 );
+		const MeshObject<Vertex> exact = GetParamSurfMesh( ScalarOnlySurface<Torus>( Torus() ), 100, 100, MeshTopology::TriangleList, serialPool );
+		const MeshObject<Vertex> approx = GetParamSurfMesh( FiniteDifferenceTorus(), 100, 100, MeshTopology::TriangleList, serialPool );
+		float maxError = 0.0f;
+		for ( std::size_t i = 0; i < exact.vertexArray.size(); ++i )
+		{
+			maxError = std::max( maxError, glm::length( exact.vertexArray[ i ].normal - approx.vertexArray[ i ].normal ) );
+		}
+		if ( maxError > 5e-3f )
+		{
+			std::printf( "  MISMATCH: Torus dual number normals differ from finite differences by %g\n", maxError );
+			g_mismatch = true;
+		}
+	}
+
+	if ( !config.quick )
+	{
+		BenchParamSurf( config, "GetParamSurfMesh<Torus>", Torus(), 1024, 1024 );
+		BenchParamSurf( config, "GetParamSurfMesh<Sphere>", Sphere( 2.0f ), 1024, 512 );
+	}
+	if ( config.large )
+		BenchParamSurf( config, "GetParamSurfMesh<Torus>", Torus(), 4096, 4096 );
+}
+
+// Az OBJ lapjainak csúcsai (0-tól számozott v/vt/vn) a fájlbeli sorrendben, háromszögelés nélkül
+static std::vector<IndexedVert> ReadObjFaceCorners( const std::filesystem::path& path )
+{
+	std::vector<IndexedVert> corners;
+	std::ifstream file( path );
+	std::string line;
+	while ( std::getline( file, line ) )
+	{
+		if ( line.size() < 2 || line[ 0 ] != 'f' || ( line[ 1 ] != ' ' && line[ 1 ] != '\t' ) ) continue;
+
+		const char* ptr = line.c_str() + 1;
+		for ( ;; )
+		{
+			while ( *ptr == ' ' || *ptr == '\t' ) ++ptr;
+			if ( *ptr == '\0' || *ptr == '\r' ) break;
+
+			std::uint32_t ids[ 3 ] = { 0, 0, 0 };
+			for ( int k = 0; k < 3; ++k )
+			{
+				char* end;
+				ids[ k ] = static_cast<std::uint32_t>( std::strtoul( ptr, &end, 10 ) );
+				ptr = end;
+				if ( *ptr != '/' ) break;
+				++ptr;
+			}
+			while ( *ptr != '\0' && *ptr != ' ' && *ptr != '\t' && *ptr != '\r' ) ++ptr;
+
+			corners.push_back( IndexedVert{ ids[ 0 ] - 1, ids[ 1 ] ? ids[ 1 ] - 1 : 0, ids[ 2 ] ? ids[ 2 ] - 1 : 0 } );
+		}
+	}
+	return corners;
+}
+
+// Ugyanazt a kulcssorozatot vonja össze a régi std::unordered_map-pel és a VertexIndexMap-pel.
+// cornerCount darab kulcs, corner( i ) adja az i. kulcsot; expectedUnique: a táblák előfoglalása.
+template <typename CornerFunc>
+static void BenchDedupMaps( const BenchConfig& config, const std::string& name, std::size_t cornerCount, std::size_t expectedUnique, CornerFunc&& corner )
+{
+	std::size_t uniqueCounts[ 2 ] = { 0, 0 };
+
+	BenchResult result = Measure( config, [ & ]()
+	{
+		std::unordered_map<IndexedVert, std::uint32_t, IndexedVertHash> vertexIndices;
+		vertexIndices.reserve( expectedUnique );
+		std::uint64_t checksum = 0;
+		for ( std::size_t i = 0; i < cornerCount; ++i )
+		{
+			checksum += vertexIndices.try_emplace( corner( i ), static_cast<std::uint32_t>( vertexIndices.size() ) ).first->second;
+		}
+		uniqueCounts[ 0 ] = vertexIndices.size();
+		g_sink = g_sink + checksum;
+	} );
+	Report( name + " std::unordered_map", result, double( cornerCount ), "lookups/s" );
+
+	result = Measure( config, [ & ]()
+	{
+		VertexIndexMap vertexIndices( expectedUnique );
+		std::uint64_t checksum = 0;
+		for ( std::size_t i = 0; i < cornerCount; ++i )
+		{
+			checksum += vertexIndices.TryEmplace( corner( i ), static_cast<std::uint32_t>( vertexIndices.Size() ) ).first;
+		}
+		uniqueCounts[ 1 ] = vertexIndices.Size();
+		g_sink = g_sink + checksum;
+	} );
+	Report( name + " VertexIndexMap", result, double( cornerCount ), "lookups/s" );
+
+	if ( uniqueCounts[ 0 ] != uniqueCounts[ 1 ] )
+	{
+		std::fprintf( stderr, "MISMATCH: %s: %zu vs %zu unique vertices\n", name.c_str(), uniqueCounts[ 0 ], uniqueCounts[ 1 ] );
+		g_mismatch = true;
+	}
+}
+
+static void BenchVertexDedup( const BenchConfig& config )
+{
+	const std::vector<IndexedVert> objCorners = ReadObjFaceCorners( config.objPath );
+	BenchDedupMaps( config, "dedup " + config.objPath.filename().string(), objCorners.size(), objCorners.size() / 4,
+					[ &objCorners ]( std::size_t i ) { return objCorners[ i ]; } );
+
+	// háromszögrács, mint GenerateGridObj (v == vt == vn), a kulcsok menet közben generálva;
+	// 2236^2 négyszög ~ 10M háromszög
+	const std::uint32_t side = config.quick ? 256 : 2236;
+	const std::size_t cornerCount = std::size_t( side ) * side * 6;
+	BenchDedupMaps( config, "dedup grid " + std::to_string( cornerCount / 3 ) + " tris", cornerCount, cornerCount / 4,
+					[ side ]( std::size_t i )
+					{
+						constexpr std::uint32_t quadCorners[ 6 ][ 2 ] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+						const std::size_t quad = i / 6;
+						const std::uint32_t x = static_cast<std::uint32_t>( quad % side ) + quadCorners[ i % 6 ][ 0 ];
+						const std::uint32_t y = static_cast<std::uint32_t>( quad / side ) + quadCorners[ i % 6 ][ 1 ];
+						const std::uint32_t id = y * ( side + 1 ) + x;
+						return IndexedVert{ id, id, id };
+					} );
+}
+
+static void BenchMeshOptimize( const BenchConfig& config, const std::string& name, const MeshObject<Vertex>& mesh )
+{
+	MeshOptimizationStats stats;
+	BenchResult result = Measure( config, [ & ]()
+	{
+		MeshObject<Vertex> optimized = mesh;
+		stats = OptimizeMesh( optimized );
+		g_sink = g_sink + optimized.indexArray[ 0 ];
+	} );
+
+	Report( "OptimizeMesh " + name, result, double( mesh.indexArray.size() / 3 ), "tris/s" );
+	std::printf( "    ACMR %.3f -> %.3f   ATVR %.3f -> %.3f (FIFO %u)\n",
+				 stats.before.acmr, stats.after.acmr, stats.before.atvr, stats.after.atvr, VERTEX_CACHE_SIZE );
+}
+
+static void BenchMeshOptimizer( const BenchConfig& config )
+{
+	BenchMeshOptimize( config, config.objPath.filename().string(), ObjParser::parse( config.objPath ) );
+	BenchMeshOptimize( config, "Torus 50x50", GetParamSurfMesh( Torus(), 50, 50 ) );
+	BenchMeshOptimize( config, "Sphere 80x40", GetParamSurfMesh( Sphere( 2.0f ) ) );
+	if ( !config.quick )
+		BenchMeshOptimize( config, "Torus 1024x1024", GetParamSurfMesh( Torus(), 1024, 1024 ) );
+}
+
+static void BenchPackMesh( const BenchConfig& config, const std::string& name, const MeshObject<Vertex>& mesh )
+{
+	PackedMesh packed;
+	BenchResult result = Measure( config, [ & ]()
+	{
+		packed = PackMesh( mesh );
+		g_sink = g_sink + packed.mesh.vertexArray.size();
+	} );
+
+	Report( "PackMesh " + name, result, double( mesh.vertexArray.size() ), "verts/s", mesh.vertexArray.size() * sizeof( Vertex ) / 1e6, "MB/s" );
+
+	// visszafejtési hibák: pozíció a befoglaló doboz legnagyobb méretéhez képest, normális szögben, texcoord abszolút
+	const glm::vec3& scale = packed.quantization.scale;
+	const float boxSize = 2.0f * std::max( scale.x, std::max( scale.y, scale.z ) );
+	float maxPositionError = 0.0f, maxNormalError = 0.0f, maxTexcoordError = 0.0f;
+	for ( std::size_t i = 0; i < mesh.vertexArray.size(); ++i )
+	{
+		const Vertex& v = mesh.vertexArray[ i ];
+		const Vertex unpacked = UnpackVertex( packed.mesh.vertexArray[ i ], packed.quantization );
+		maxPositionError = std::max( maxPositionError, glm::length( unpacked.position - v.position ) / boxSize );
+		maxNormalError = std::max( maxNormalError, std::acos( std::min( 1.0f, glm::dot( unpacked.normal, glm::normalize( v.normal ) ) ) ) );
+		maxTexcoordError = std::max( maxTexcoordError, std::max( std::abs( unpacked.texcoord.x - v.texcoord.x ), std::abs( unpacked.texcoord.y - v.texcoord.y ) ) );
+	}
+	std::printf( "    %zu -> %zu bytes/vertex (%.2fx)   max error: position %.2e, normal %.2f deg, texcoord %.2e\n",
+				 sizeof( Vertex ), sizeof( VertexPacked ), double( sizeof( Vertex ) ) / sizeof( VertexPacked ),
+				 maxPositionError, glm::degrees( maxNormalError ), maxTexcoordError );
+}
+
+static void BenchMeshPacking( const BenchConfig& config )
+{
+	BenchPackMesh( config, config.objPath.filename().string(), ObjParser::parse( config.objPath ) );
+	BenchPackMesh( config, "Torus 50x50", GetParamSurfMesh( Torus(), 50, 50 ) );
+	if ( !config.quick )
+		BenchPackMesh( config, "Torus 1024x1024", GetParamSurfMesh( Torus(), 1024, 1024 ) );
+}
+
+static void BenchCollision( const BenchConfig& config )
+{
+	const float sphereRadius = 2.0f;
+	constexpr int queryCount = 1024;
+
+	std::vector<int> sphereCounts = config.quick ? std::vector<int>{ 10, 1000 } : std::vector<int>{ 10, 1000, 10000 };
+	if ( config.large ) sphereCounts.push_back( 100000 );
+
+	for ( int sphereCount : sphereCounts )
+	{
+		// egymással nem ütköző gömbök egy köbrácsban, 2.5 sugárnyi távolságra
+		std::vector<glm::vec3> spheres;
+		spheres.reserve( sphereCount );
+		const int side = static_cast<int>( std::ceil( std::cbrt( double( sphereCount ) ) ) );
+		for ( int i = 0; static_cast<int>( spheres.size() ) < sphereCount; ++i )
+		{
+			spheres.emplace_back( glm::vec3( i % side, ( i / side ) % side, i / ( side * side ) ) * ( 2.5f * sphereRadius ) );
+		}
+
+		std::mt19937 rng( 42 );
+		std::uniform_real_distribution<float> dist( -10.0f, side * 2.5f * sphereRadius + 10.0f );
+		std::vector<glm::vec3> queries( queryCount );
+		for ( glm::vec3& q : queries ) q = glm::vec3( dist( rng ), dist( rng ), dist( rng ) );
+
+		BenchResult result = Measure( config, [ & ]()
+		{
+			std::uint64_t hits = 0;
+			for ( const glm::vec3& q : queries ) hits += HasCollidingSpheres( spheres, q, sphereRadius ) ? 1 : 0;
+			g_sink = g_sink + hits;
+		} );
+
+		Report( "HasCollidingSpheres N=" + std::to_string( sphereCount ), result, double( queryCount ), "checks/s", double( queryCount ) * sphereCount, "pairs/s" );
+
+		// ugyanez rácsban; a rács felépítése (tömeges beszúrás) külön mérve
+		SphereGrid grid( 2.0f * sphereRadius );
+		BenchResult buildResult = Measure( config, [ & ]()
+		{
+			grid.Clear();
+			grid.Insert( spheres, sphereRadius );
+			g_sink = g_sink + grid.Size();
+		} );
+		Report( "SphereGrid::Insert N=" + std::to_string( sphereCount ), buildResult, double( sphereCount ), "spheres/s" );
+
+		BenchResult gridResult = Measure( config, [ & ]()
+		{
+			std::uint64_t hits = 0;
+			for ( const glm::vec3& q : queries ) hits += grid.Overlaps( q, sphereRadius ) ? 1 : 0;
+			g_sink = g_sink + hits;
+		} );
+		Report( "SphereGrid::Overlaps N=" + std::to_string( sphereCount ), gridResult, double( queryCount ), "checks/s" );
+
+		for ( const glm::vec3& q : queries )
+		{
+			if ( grid.Overlaps( q, sphereRadius ) != HasCollidingSpheres( spheres, q, sphereRadius ) )
+			{
+				std::printf( "  MISMATCH: SphereGrid and HasCollidingSpheres disagree\n" );
+				g_mismatch = true;
+				break;
+			}
+		}
+	}
+
+	// a gombbal való létrehozás menete: ütközésvizsgálat, majd beszúrás, nagy számú gömbre
+	{
+		const int sphereCount = config.large ? 100000 : 10000;
+		std::mt19937 rng( 7 );
+		const float extent = 4.0f * sphereRadius * std::cbrt( float( sphereCount ) );
+		std::uniform_real_distribution<float> dist( 0.0f, extent );
+		std::vector<glm::vec3> candidates( sphereCount );
+		for ( glm::vec3& c : candidates ) c = glm::vec3( dist( rng ), dist( rng ), dist( rng ) );
+
+		BenchResult result = Measure( config, [ & ]()
+		{
+			SphereGrid grid( 2.0f * sphereRadius );
+			for ( const glm::vec3& c : candidates )
+			{
+				if ( !grid.Overlaps( c, sphereRadius ) ) grid.Insert( c, sphereRadius );
+			}
+			g_sink = g_sink + grid.Size();
+		} );
+		Report( "SphereGrid place " + std::to_string( sphereCount ) + " candidates", result, double( sphereCount ), "candidates/s" );
+	}
+}
+
+static void BenchPoissonDisk( const BenchConfig& config )
+{
+	const float sphereRadius = 2.0f;
+	PoissonDiskSettings settings;
+	settings.minDistance = 2.0f * sphereRadius;
+
+	std::vector<float> boxSizes = config.quick ? std::vector<float>{ 100.0f } : std::vector<float>{ 100.0f, 250.0f };
+	if ( config.large ) boxSizes.push_back( 600.0f );
+
+	for ( float boxSize : boxSizes )
+	{
+		const glm::vec3 boxMin( 0.0f ), boxMax( boxSize );
+		std::vector<glm::vec3> samples;
+		BenchResult result = Measure( config, [ & ]()
+		{
+			samples = GeneratePoissonDisk( boxMin, boxMax, settings );
+			g_sink = g_sink + samples.size();
+		} );
+
+		Report( "GeneratePoissonDisk box " + std::to_string( int( boxSize ) ) + " (" + std::to_string( samples.size() ) + ")",
+				result, double( samples.size() ), "spheres/s" );
+
+		// egyik gömb sem ütközhet a korábbiakkal, és az eredmény nem függhet a szálak számától
+		SphereGrid grid( 2.0f * sphereRadius );
+		for ( const glm::vec3& p : samples )
+		{
+			if ( grid.Overlaps( p, sphereRadius ) )
+			{
+				std::printf( "  MISMATCH: GeneratePoissonDisk produced overlapping spheres\n" );
+				g_mismatch = true;
+				break;
+			}
+			grid.Insert( p, sphereRadius );
+		}
+
+		ThreadPool serialPool( 1 );
+		if ( GeneratePoissonDisk( boxMin, boxMax, settings, serialPool ) != samples )
+		{
+			std::printf( "  MISMATCH: GeneratePoissonDisk depends on the thread count\n" );
+			g_mismatch = true;
+		}
+	}
+}
+
+static void BenchFrustumCulling( const BenchConfig& config )
+{
+	// a gúla a [-1, 1]^3 kocka (egységmátrix view-projection), a gömbök a [-2, 2]^3 kockában: nagyjából 1/6-uk látszik
+	const Frustum frustum = ExtractFrustum( glm::mat4( 1.0f ) );
+
+	std::vector<std::size_t> sphereCounts = config.quick ? std::vector<std::size_t>{ 1000, 100000 } : std::vector<std::size_t>{ 1000, 100000, 1000000 };
+	if ( config.large ) sphereCounts.push_back( 10000000 );
+
+	for ( std::size_t sphereCount : sphereCounts )
+	{
+		std::mt19937 rng( 11 );
+		std::uniform_real_distribution<float> position( -2.0f, 2.0f );
+		std::uniform_real_distribution<float> radius( 0.0f, 0.1f );
+
+		BoundingSphereArray spheres;
+		spheres.Resize( sphereCount );
+		for ( std::size_t i = 0; i < sphereCount; ++i )
+		{
+			spheres.Set( i, glm::vec3( position( rng ), position( rng ), position( rng ) ), radius( rng ) );
+		}
+
+		std::vector<std::uint32_t> visible;
+		visible.reserve( sphereCount );
+		BenchResult result = Measure( config, [ & ]()
+		{
+			visible.clear();
+			g_sink = g_sink + CullSpheres( frustum, spheres, visible );
+		} );
+
+		Report( "CullSpheres N=" + std::to_string( sphereCount ) + " (" + std::to_string( visible.size() ) + " visible)",
+				result, double( sphereCount ), "spheres/s" );
+
+		// a SIMD változatnak a skalár IsSphereInFrustum-mal azonos indexeket kell adnia
+		std::vector<std::uint32_t> expected;
+		for ( std::size_t i = 0; i < sphereCount; ++i )
+		{
+			const glm::vec3 center( spheres.CenterX()[ i ], spheres.CenterY()[ i ], spheres.CenterZ()[ i ] );
+			if ( IsSphereInFrustum( frustum, center, spheres.Radius()[ i ] ) ) expected.push_back( static_cast<std::uint32_t>( i ) );
+		}
+		if ( expected != visible )
+		{
+			std::printf( "  MISMATCH: CullSpheres differs from IsSphereInFrustum\n" );
+			g_mismatch = true;
+		}
+	}
+}
+
+static void BenchRangeAllocator( const BenchConfig& config )
+{
+	// véletlen foglalás / felszabadítás, a foglalt elemek egy bittérképpel ellenőrizve: nem fedhetik egymást,
+	// a szabad elemek száma egyezik, és minden darab visszaadása után nem maradhat töredezettség
+	const std::size_t capacity = 1 << 16;
+	const int operationCount = config.quick ? 20000 : 200000;
+
+	struct Allocation
+	{
+		std::size_t offset;
+		std::size_t count;
+	};
+
+	std::mt19937 rng( 23 );
+	std::uniform_int_distribution<std::size_t> size( 1, 1024 );
+
+	RangeAllocator allocator( capacity );
+	std::vector<Allocation> allocations;
+	std::vector<std::uint8_t> used( capacity, 0 );
+	std::size_t usedCount = 0;
+	bool ok = true;
+
+	for ( int op = 0; op < operationCount && ok; ++op )
+	{
+		if ( !allocations.empty() && rng() % 2 == 0 )
+		{
+			const std::size_t i = rng() % allocations.size();
+			const Allocation a = allocations[ i ];
+			allocations[ i ] = allocations.back();
+			allocations.pop_back();
+
+			allocator.Free( a.offset, a.count );
+			std::fill( used.begin() + a.offset, used.begin() + a.offset + a.count, std::uint8_t( 0 ) );
+			usedCount -= a.count;
+			continue;
+		}
+
+		const std::size_t count = size( rng );
+		const std::size_t offset = allocator.Allocate( count );
+		if ( offset == RangeAllocator::INVALID ) continue;
+
+		ok = offset + count <= capacity &&
+			std::none_of( used.begin() + offset, used.begin() + offset + count, []( std::uint8_t u ) { return u != 0; } );
+		std::fill( used.begin() + offset, used.begin() + offset + count, std::uint8_t( 1 ) );
+		usedCount += count;
+		allocations.push_back( { offset, count } );
+	}
+	ok = ok && allocator.FreeCount() == capacity - usedCount;
+
+	for ( const Allocation& a : allocations ) allocator.Free( a.offset, a.count );
+	ok = ok && allocator.FreeCount() == capacity && allocator.FreeRangeCount() == 1;
+
+	if ( !ok )
+	{
+		std::printf( "  MISMATCH: RangeAllocator handed out overlapping ranges or lost free space\n" );
+		g_mismatch = true;
+	}
+
+	// a fánk felbontás csúszkájának húzása az arénában: néhány állandó háló mellett egy újra és újra lecserélt
+	BenchResult result = Measure( config, [ & ]()
+	{
+		RangeAllocator arena( capacity );
+		for ( int i = 0; i < 8; ++i ) g_sink = g_sink + arena.Allocate( 4096 );
+
+		std::size_t offset = arena.Allocate( 1 );
+		std::size_t count = 1;
+		for ( int n = 1; n <= 1000; ++n )
+		{
+			arena.Free( offset, count );
+			count = ( n % 100 + 1 ) * ( n % 100 + 1 );
+			offset = arena.Allocate( count );
+		}
+		g_sink = g_sink + offset + arena.FreeRangeCount();
+	} );
+	Report( "RangeAllocator resize 1000x", result, 1000.0, "resizes/s" );
+}
+
+static void BenchRadixSort( const BenchConfig& config )
+{
+	// a gömb példányok kulcsai: (LOD << 32) | távolság; a felső bitek szinte állandók, ezeket a menetek átugorják
+	const std::size_t n = config.quick ? 20000 : 200000;
+
+	std::mt19937 rng( 25 );
+	std::uniform_real_distribution<float> distance( 0.0f, 500.0f );
+	std::vector<SortItem> sphereKeys( n );
+	for ( std::size_t i = 0; i < n; ++i )
+		sphereKeys[ i ] = SortItem{ ( std::uint64_t( rng() % 3 ) << 32 ) | FloatSortKey( distance( rng ) ), static_cast<std::uint32_t>( i ) };
+
+	std::vector<SortItem> randomKeys( n );
+	for ( std::size_t i = 0; i < n; ++i )
+		randomKeys[ i ] = SortItem{ ( std::uint64_t( rng() ) << 32 ) | rng(), static_cast<std::uint32_t>( i ) };
+
+	// stabilitás és előjeles float-ok: sok ismétlődő, negatív és pozitív kulcs
+	std::uniform_int_distribution<int> smallValue( -50, 50 );
+	std::vector<SortItem> floatKeys( n );
+	for ( std::size_t i = 0; i < n; ++i )
+		floatKeys[ i ] = SortItem{ FloatSortKey( 0.25f * smallValue( rng ) ), static_cast<std::uint32_t>( i ) };
+
+	std::vector<SortItem> items, scratch;
+	for ( const auto& [ name, keys ] : { std::make_pair( "sphere", &sphereKeys ), std::make_pair( "random", &randomKeys ), std::make_pair( "float", &floatKeys ) } )
+	{
+		std::vector<SortItem> expected = *keys;
+		std::stable_sort( expected.begin(), expected.end(), []( const SortItem& a, const SortItem& b ) { return a.key < b.key; } );
+
+		items = *keys;
+		RadixSort( items, scratch );
+		const bool ok = std::equal( items.begin(), items.end(), expected.begin(),
+									[]( const SortItem& a, const SortItem& b ) { return a.key == b.key && a.value == b.value; } );
+		if ( !ok )
+		{
+			std::printf( "  MISMATCH: RadixSort (%s keys) differs from std::stable_sort\n", name );
+			g_mismatch = true;
+		}
+
+		BenchResult result = Measure( config, [ & ]()
+		{
+			items = *keys;
+			RadixSort( items, scratch );
+			g_sink = g_sink + items[ 0 ].value;
+		} );
+		Report( std::string( "RadixSort " ) + name + " n=" + std::to_string( n ), result, n / 1e6, "Mkeys/s" );
+
+		result = Measure( config, [ & ]()
+		{
+			items = *keys;
+			std::stable_sort( items.begin(), items.end(), []( const SortItem& a, const SortItem& b ) { return a.key < b.key; } );
+			g_sink = g_sink + items[ 0 ].value;
+		} );
+		Report( std::string( "std::stable_sort " ) + name + " n=" + std::to_string( n ), result, n / 1e6, "Mkeys/s" );
+	}
+}
+
+static void BenchTriangulation( const BenchConfig& config )
+{
+	for ( int n : { 8, 64, 256 } )
+	{
+		if ( config.quick && n > 64 ) break;
+
+		const std::vector<glm::vec2> polygon = GenerateStarPolygon( n );
+		BenchResult result = Measure( config, [ & ]()
+		{
+			std::vector<unsigned int> tris = ObjParser::triangulatePolygon( polygon );
+			g_sink = g_sink + tris.size();
+		} );
+
+		Report( "triangulatePolygon n=" + std::to_string( n ), result, double( n - 2 ), "tris/s" );
+	}
+}
+
+static void BenchInvertImage( const BenchConfig& config )
+{
+	for ( int side : { 1024, 4096 } )
+	{
+		if ( config.quick && side > 1024 ) break;
+
+		std::vector<std::uint32_t> image( static_cast<std::size_t>( side ) * side );
+		for ( std::size_t i = 0; i < image.size(); ++i ) image[ i ] = static_cast<std::uint32_t>( i * 2654435761u );
+
+		BenchResult result = Measure( config, [ & ]()
+		{
+			invert_image_RGBA( side, side, image.data() );
+			g_sink = g_sink + image[ 0 ];
+		} );
+
+		Report( "invert_image_RGBA " + std::to_string( side ) + "^2", result, image.size() * sizeof( std::uint32_t ) / 1e6, "MB/s" );
+	}
+}
+
+int main( int argc, char* argv[] )
+{
+	BenchConfig config;
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		if ( std::strcmp( argv[ i ], "--quick" ) == 0 )
+		{
+			config.quick = true;
+			config.minTimeSec = 0.1;
+		}
+		else if ( std::strcmp( argv[ i ], "--large" ) == 0 )
+		{
+			config.large = true;
+		}
+		else if ( std::strcmp( argv[ i ], "--min-time" ) == 0 && i + 1 < argc )
+		{
+			config.minTimeSec = std::atof( argv[ ++i ] );
+		}
+		else if ( argv[ i ][ 0 ] != '-' )
+		{
+			config.objPath = argv[ i ];
+		}
+		else
+		{
+			std::fprintf( stderr, "usage: %s [--quick] [--large] [--min-time <sec>] [<obj file>]\n", argv[ 0 ] );
+			return 1;
+		}
+	}
+
+	std::printf( "threads: %u\n", ThreadPool::Global().GetThreadCount() );
+	std::printf( "%-44s %13s %22s %26s %28s\n", "benchmark", "best", "throughput", "", "allocations / iteration" );
+
+	BenchObjParser( config );
+	BenchVertexDedup( config );
+	BenchMeshOptimizer( config );
+	BenchMeshPacking( config );
+	BenchParamSurfaces( config );
+	BenchCollision( config );
+	BenchPoissonDisk( config );
+	BenchFrustumCulling( config );
+	BenchRangeAllocator( config );
+	BenchRadixSort( config );
+	BenchTriangulation( config );
+	BenchInvertImage( config );
+
+	return g_mismatch ? 1 : 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+// Előre haladó (forward mode) automatikus deriválás duális számokkal: x = value + derivative * e, ahol e^2 = 0.
+// Egy függvényt Dual( x, 1 )-re kiértékelve az eredmény derivative része a függvény x szerinti deriváltja,
+// pontosan (nincs véges differencia és epszilon). A parametrikus felületek normálisához használjuk: egy
+// sablonként megírt GetPos-t Dual paraméterekkel hívva megkapjuk a pozíció u vagy v szerinti parciális deriváltját.
+struct Dual
+{
+	float value = 0.0f;
+	float derivative = 0.0f;
+
+	constexpr Dual() = default;
+	constexpr Dual( float _value, float _derivative = 0.0f ) : value( _value ), derivative( _derivative ) { }
+
+	Dual& operator*=( float s ) noexcept { value *= s; derivative *= s; return *this; }
+};
+
+constexpr Dual operator-( Dual a ) noexcept { return { -a.value, -a.derivative }; }
+
+constexpr Dual operator+( Dual a, Dual b ) noexcept { return { a.value + b.value, a.derivative + b.derivative }; }
+constexpr Dual operator-( Dual a, Dual b ) noexcept { return { a.value - b.value, a.derivative - b.derivative }; }
+constexpr Dual operator*( Dual a, Dual b ) noexcept { return { a.value * b.value, a.derivative * b.value + a.value * b.derivative }; }
+constexpr Dual operator/( Dual a, Dual b ) noexcept { return { a.value / b.value, ( a.derivative * b.value - a.value * b.derivative ) / ( b.value * b.value ) }; }
+
+constexpr Dual operator+( Dual a, float s ) noexcept { return { a.value + s, a.derivative }; }
+constexpr Dual operator+( float s, Dual a ) noexcept { return a + s; }
+constexpr Dual operator-( Dual a, float s ) noexcept { return { a.value - s, a.derivative }; }
+constexpr Dual operator-( float s, Dual a ) noexcept { return { s - a.value, -a.derivative }; }
+constexpr Dual operator*( Dual a, float s ) noexcept { return { a.value * s, a.derivative * s }; }
+constexpr Dual operator*( float s, Dual a ) noexcept { return a * s; }
+constexpr Dual operator/( Dual a, float s ) noexcept { return { a.value / s, a.derivative / s }; }
+
+// a felületek a float-os változattal közös kódban, minősítés nélkül hívják (using std::sin; sin( x ))
+inline Dual sin( Dual a ) noexcept { return { std::sin( a.value ), std::cos( a.value ) * a.derivative }; }
+inline Dual cos( Dual a ) noexcept { return { std::cos( a.value ), -std::sin( a.value ) * a.derivative }; }
+inline Dual sqrt( Dual a ) noexcept
+{
+	const float root = std::sqrt( a.value );
+	return { root, a.derivative / ( 2.0f * root ) };
+}
+
+// Duális komponensű 3D vektor: a pont és az egyetlen (Dual( x, 1 )-gyel jelölt) paraméter szerinti deriváltja
+struct DualVec3
+{
+	glm::vec3 value;
+	glm::vec3 derivative;
+};
+
+// A felületek GetPos-a ezzel rakja össze az eredményt: float-ra glm::vec3, Dual-ra DualVec3
+inline glm::vec3 MakeVec3( float x, float y, float z ) noexcept { return glm::vec3( x, y, z ); }
+inline DualVec3 MakeVec3( Dual x, Dual y, Dual z ) noexcept
+{
+	return { glm::vec3( x.value, y.value, z.value ), glm::vec3( x.derivative, y.derivative, z.derivative ) };
+}
@@ -0,0 +1,162 @@
+#include "Frustum.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define FRUSTUM_SSE2
+#endif
+
+Frustum ExtractFrustum( const glm::mat4& viewProj ) noexcept
+{
+	// glm oszlopfolytonos: az i. sor ( m[0][i], m[1][i], m[2][i], m[3][i] )
+	auto row = [ & ]( int i ) { return glm::vec4( viewProj[ 0 ][ i ], viewProj[ 1 ][ i ], viewProj[ 2 ][ i ], viewProj[ 3 ][ i ] ); };
+	const glm::vec4 r0 = row( 0 ), r1 = row( 1 ), r2 = row( 2 ), r3 = row( 3 );
+
+	Frustum frustum;
+	frustum.planes[ 0 ] = r3 + r0; // bal
+	frustum.planes[ 1 ] = r3 - r0; // jobb
+	frustum.planes[ 2 ] = r3 + r1; // alsó
+	frustum.planes[ 3 ] = r3 - r1; // felső
+	frustum.planes[ 4 ] = r3 + r2; // közeli
+	frustum.planes[ 5 ] = r3 - r2; // távoli
+
+	// normalizálva, hogy a sík egyenlete előjeles távolságot adjon
+	for ( glm::vec4& plane : frustum.planes )
+	{
+		plane /= glm::length( glm::vec3( plane ) );
+	}
+
+	return frustum;
+}
+
+bool IsSphereInFrustum( const Frustum& frustum, const glm::vec3& center, float radius ) noexcept
+{
+	for ( const glm::vec4& plane : frustum.planes )
+	{
+		// a CullSpheres műveleti sorrendjében, hogy a kettő bitre azonos eredményt adjon
+		const float d = ( plane.x * center.x + plane.y * center.y ) + ( plane.z * center.z + plane.w );
+		if ( d < -radius ) return false;
+	}
+	return true;
+}
+
+void BoundingSphereArray::Resize( std::size_t count )
+{
+	const std::size_t paddedCount = ( count + LANE_COUNT - 1 ) / LANE_COUNT * LANE_COUNT;
+
+	m_centerX.resize( paddedCount, 0.0f );
+	m_centerY.resize( paddedCount, 0.0f );
+	m_centerZ.resize( paddedCount, 0.0f );
+	m_radius.resize( paddedCount, -std::numeric_limits<float>::infinity() );
+
+	// zsugorításnál a levágott, de a kitöltésben maradó elemeket is üresre állítjuk
+	for ( std::size_t i = count; i < std::min( m_size, paddedCount ); ++i )
+	{
+		m_radius[ i ] = -std::numeric_limits<float>::infinity();
+	}
+
+	m_size = count;
+}
+
+void BoundingSphereArray::Set( std::size_t index, const glm::vec3& center, float radius ) noexcept
+{
+	m_centerX[ index ] = center.x;
+	m_centerY[ index ] = center.y;
+	m_centerZ[ index ] = center.z;
+	m_radius[ index ] = radius;
+}
+
+// a mask (8 bit) 1-es bitjeinek megfelelő indexek hozzáfűzése
+static inline void AppendLanes( unsigned int mask, std::uint32_t base, std::vector<std::uint32_t>& visible )
+{
+	for ( ; mask != 0; mask &= mask - 1 )
+	{
+		unsigned int lane = 0;
+		while ( ( ( mask >> lane ) & 1u ) == 0 ) ++lane;
+		visible.push_back( base + lane );
+	}
+}
+
+std::size_t CullSpheres( const Frustum& frustum, const BoundingSphereArray& spheres, std::vector<std::uint32_t>& visible )
+{
+	const std::size_t oldSize = visible.size();
+	const std::size_t paddedSize = spheres.PaddedSize();
+	const float* cx = spheres.CenterX();
+	const float* cy = spheres.CenterY();
+	const float* cz = spheres.CenterZ();
+	const float* cr = spheres.Radius();
+
+#if defined(__AVX2__)
+	__m256 planes[ Frustum::PLANE_COUNT ][ 4 ];
+	for ( int p = 0; p < Frustum::PLANE_COUNT; ++p )
+	{
+		for ( int c = 0; c < 4; ++c ) planes[ p ][ c ] = _mm256_set1_ps( frustum.planes[ p ][ c ] );
+	}
+
+	for ( std::size_t i = 0; i < paddedSize; i += BoundingSphereArray::LANE_COUNT )
+	{
+		const __m256 x = _mm256_loadu_ps( cx + i );
+		const __m256 y = _mm256_loadu_ps( cy + i );
+		const __m256 z = _mm256_loadu_ps( cz + i );
+		const __m256 negRadius = _mm256_sub_ps( _mm256_setzero_ps(), _mm256_loadu_ps( cr + i ) );
+
+		__m256 outside = _mm256_setzero_ps();
+		for ( int p = 0; p < Frustum::PLANE_COUNT; ++p )
+		{
+			const __m256 d = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( planes[ p ][ 0 ], x ), _mm256_mul_ps( planes[ p ][ 1 ], y ) ),
+											_mm256_add_ps( _mm256_mul_ps( planes[ p ][ 2 ], z ), planes[ p ][ 3 ] ) );
+			outside = _mm256_or_ps( outside, _mm256_cmp_ps( d, negRadius, _CMP_LT_OQ ) );
+		}
+
+		AppendLanes( ~static_cast<unsigned int>( _mm256_movemask_ps( outside ) ) & 0xffu, static_cast<std::uint32_t>( i ), visible );
+	}
+#elif defined(FRUSTUM_SSE2)
+	__m128 planes[ Frustum::PLANE_COUNT ][ 4 ];
+	for ( int p = 0; p < Frustum::PLANE_COUNT; ++p )
+	{
+		for ( int c = 0; c < 4; ++c ) planes[ p ][ c ] = _mm_set1_ps( frustum.planes[ p ][ c ] );
+	}
+
+	for ( std::size_t i = 0; i < paddedSize; i += BoundingSphereArray::LANE_COUNT )
+	{
+		unsigned int visibleMask = 0;
+		for ( std::size_t half = 0; half < 8; half += 4 )
+		{
+			const __m128 x = _mm_loadu_ps( cx + i + half );
+			const __m128 y = _mm_loadu_ps( cy + i + half );
+			const __m128 z = _mm_loadu_ps( cz + i + half );
+			const __m128 negRadius = _mm_sub_ps( _mm_setzero_ps(), _mm_loadu_ps( cr + i + half ) );
+
+			__m128 outside = _mm_setzero_ps();
+			for ( int p = 0; p < Frustum::PLANE_COUNT; ++p )
+			{
+				const __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planes[ p ][ 0 ], x ), _mm_mul_ps( planes[ p ][ 1 ], y ) ),
+											 _mm_add_ps( _mm_mul_ps( planes[ p ][ 2 ], z ), planes[ p ][ 3 ] ) );
+				outside = _mm_or_ps( outside, _mm_cmplt_ps( d, negRadius ) );
+			}
+
+			visibleMask |= ( ~static_cast<unsigned int>( _mm_movemask_ps( outside ) ) & 0xfu ) << half;
+		}
+
+		AppendLanes( visibleMask, static_cast<std::uint32_t>( i ), visible );
+	}
+#else
+	for ( std::size_t i = 0; i < paddedSize; ++i )
+	{
+		bool outside = false;
+		for ( const glm::vec4& plane : frustum.planes )
+		{
+			// ugyanabban a sorrendben, mint a SIMD változatok és az IsSphereInFrustum
+			const float d = ( plane.x * cx[ i ] + plane.y * cy[ i ] ) + ( plane.z * cz[ i ] + plane.w );
+			outside |= d < -cr[ i ];
+		}
+		if ( !outside ) visible.push_back( static_cast<std::uint32_t>( i ) );
+	}
+#endif
+
+	return visible.size() - oldSize;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// A nézeti gúla hat síkja (bal, jobb, alsó, felső, közeli, távoli) világkoordinátákban, befelé néző,
+// egységhosszú normálissal: egy p pont a síkon belül van, ha dot( plane.xyz, p ) + plane.w >= 0.
+struct Frustum
+{
+	static constexpr int PLANE_COUNT = 6;
+
+	glm::vec4 planes[ PLANE_COUNT ];
+};
+
+// A síkok kiolvasása a view-projection mátrix soraiból (Gribb & Hartmann, "Fast Extraction of
+// Viewing Frustum Planes from the World-View-Projection Matrix", 2001), OpenGL-es [-w, w] mélységgel.
+Frustum ExtractFrustum( const glm::mat4& viewProj ) noexcept;
+
+// a gömb legalább részben a gúlában van-e (konzervatív: a sarkok környékén lehet hamis pozitív)
+bool IsSphereInFrustum( const Frustum& frustum, const glm::vec3& center, float radius ) noexcept;
+
+// Befoglaló gömbök SoA elrendezésben (külön x, y, z és sugár tömb) a SIMD-es vizsgálathoz.
+// A tömbök hossza 8 többszöröse; a kitöltő és a még be nem állított elemek sugara -végtelen, így sosem láthatók.
+class BoundingSphereArray
+{
+public:
+	static constexpr std::size_t LANE_COUNT = 8; // egy iterációban ennyi gömb
+
+	std::size_t Size() const noexcept { return m_size; }
+	std::size_t PaddedSize() const noexcept { return m_radius.size(); }
+
+	// az új elemek üresek (sosem láthatók), amíg a Set be nem állítja őket
+	void Resize( std::size_t count );
+	void Set( std::size_t index, const glm::vec3& center, float radius ) noexcept;
+
+	const float* CenterX() const noexcept { return m_centerX.data(); }
+	const float* CenterY() const noexcept { return m_centerY.data(); }
+	const float* CenterZ() const noexcept { return m_centerZ.data(); }
+	const float* Radius() const noexcept { return m_radius.data(); }
+
+private:
+	std::size_t        m_size = 0;
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_radius;
+};
+
+// A gúlába (legalább részben) eső gömbök indexeit növekvő sorrendben a visible végére fűzi, és visszaadja a számukat.
+// AVX2-vel (TELEPORTING_AVX2) 8 széles, különben 2 x 4 széles SSE2, SSE2 nélkül skalár.
+std::size_t CullSpheres( const Frustum& frustum, const BoundingSphereArray& spheres, std::vector<std::uint32_t>& visible );
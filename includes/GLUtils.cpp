@@ -1,6 +1,8 @@
 #include "GLUtils.hpp"
+#include "ImageUtils.hpp"
 
 #include <stdio.h>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -80,13 +82,37 @@ void compileShaderFromSource( const GLuint loadedShader, std::string_view shader
 }
 
 
-void AssembleProgram( const GLuint programID, const std::filesystem::path& vs_filename, const std::filesystem::path& fs_filename )
+// linkelés és a hibák naplózása; sikeres-e
+static bool LinkProgram( const GLuint programID )
+{
+	glLinkProgram(programID);
+
+	// linkeles ellenorzese
+	GLint infoLogLength = 0, result = 0;
+
+	glGetProgramiv(programID, GL_LINK_STATUS, &result);
+	glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &infoLogLength);
+	if (GL_FALSE == result || infoLogLength != 0 )
+	{
+		std::string ErrorMessage(infoLogLength, '\0');
+		glGetProgramInfoLog(programID, infoLogLength, nullptr, ErrorMessage.data() );
+		SDL_LogMessage( SDL_LOG_CATEGORY_ERROR, 
+						( result ) ? SDL_LOG_PRIORITY_WARN : SDL_LOG_PRIORITY_ERROR,
+						"[glLinkProgram] Shader linking error: %s" , ErrorMessage.data() );
+	}
+
+	return GL_FALSE != result;
+}
+
+ProgramUniforms AssembleProgram( const GLuint programID, const std::filesystem::path& vs_filename, const std::filesystem::path& fs_filename )
 {
 	//
 	// shaderek betöltése
 	//
 
-	if ( programID == 0 ) return;
+	ProgramUniforms uniforms;
+
+	if ( programID == 0 ) return uniforms;
 
 	GLuint vs_ID = glCreateShader( GL_VERTEX_SHADER   );
 	GLuint fs_ID = glCreateShader( GL_FRAGMENT_SHADER );
@@ -104,45 +130,143 @@ void AssembleProgram( const GLuint programID, const std::filesystem::path& vs_fi
 	glAttachShader(programID, fs_ID);
 
 	// illesszük össze a shadereket (kimenő-bemenő változók összerendelése stb.)
-	glLinkProgram(programID);
+	const bool linked = LinkProgram( programID );
 
-	// linkeles ellenorzese
-	GLint infoLogLength = 0, result = 0;
+	// mar nincs ezekre szukseg
+	glDeleteShader( vs_ID );
+	glDeleteShader( fs_ID );
 
-	glGetProgramiv(programID, GL_LINK_STATUS, &result);
-	glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (GL_FALSE == result || infoLogLength != 0 )
+	// a uniformok helyét most, egyszer kérdezzük le, nem rajzoláskor
+	if ( linked ) uniforms.Reflect( programID );
+
+	return uniforms;
+}
+
+ProgramUniforms AssembleComputeProgram( const GLuint programID, const std::filesystem::path& cs_filename )
+{
+	ProgramUniforms uniforms;
+
+	if ( programID == 0 ) return uniforms;
+
+	GLuint cs_ID = glCreateShader( GL_COMPUTE_SHADER );
+
+	if ( cs_ID == 0 )
 	{
-		std::string ErrorMessage(infoLogLength, '\0');
-		glGetProgramInfoLog(programID, infoLogLength, nullptr, ErrorMessage.data() );
-		SDL_LogMessage( SDL_LOG_CATEGORY_ERROR, 
-						( result ) ? SDL_LOG_PRIORITY_WARN : SDL_LOG_PRIORITY_ERROR,
-						"[glLinkProgram] Shader linking error: %s" , ErrorMessage.data() );
+		SDL_SetError("Error while initing shaders (glCreateShader)!");
 	}
 
-	// mar nincs ezekre szukseg
-	glDeleteShader( vs_ID );
-	glDeleteShader( fs_ID );
+	loadShader( cs_ID, cs_filename );
+
+	glAttachShader( programID, cs_ID );
+	const bool linked = LinkProgram( programID );
+	glDeleteShader( cs_ID );
+
+	if ( linked ) uniforms.Reflect( programID );
+
+	return uniforms;
+}
+
+bool UniformGLType<GLint>::Matches( GLenum type ) noexcept
+{
+	switch ( type )
+	{
+	case GL_INT:
+	case GL_BOOL:
+	case GL_SAMPLER_2D:
+	case GL_SAMPLER_3D:
+	case GL_SAMPLER_CUBE:
+	case GL_SAMPLER_2D_ARRAY:
+	case GL_SAMPLER_2D_SHADOW:
+		return true;
+	default:
+		return false;
+	}
 }
 
-static void invert_image_RGBA(int pitchInPixels, int height, Uint32* image_pixels)
+void ProgramUniforms::Reflect( GLuint programID )
 {
-	int height_div_2 = height / 2;
-	Uint32* lower_data  =image_pixels;
-	Uint32* higher_data =image_pixels + ( height - 1 ) * pitchInPixels;
+	Clear();
+	m_programID = programID;
+
+	// https://registry.khronos.org/OpenGL-Refpages/gl4/html/glGetProgramResource.xhtml
+	GLint uniformCount = 0;
+	glGetProgramInterfaceiv( programID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount );
+
+	GLint maxNameLength = 0;
+	glGetProgramInterfaceiv( programID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength );
+	std::string nameBuffer( std::max( maxNameLength, 1 ), '\0' );
 
-	for ( int index = 0; index < height_div_2; index++ )
+	const GLenum properties[] = { GL_BLOCK_INDEX, GL_TYPE, GL_LOCATION };
+	for ( GLint i = 0; i < uniformCount; ++i )
 	{
-		for ( int rowIndex = 0; rowIndex < pitchInPixels; rowIndex++ )
-		{
-			*lower_data ^= higher_data[ rowIndex ];
-			higher_data[ rowIndex ] ^= *lower_data;
-			*lower_data ^= higher_data[ rowIndex ];
+		GLint values[ 3 ] = {};
+		glGetProgramResourceiv( programID, GL_UNIFORM, i, 3, properties, 3, nullptr, values );
+		if ( values[ 0 ] != -1 ) continue; // uniform block tagja, nincs helye
+
+		GLsizei nameLength = 0;
+		glGetProgramResourceName( programID, GL_UNIFORM, i, static_cast<GLsizei>( nameBuffer.size() ), &nameLength, nameBuffer.data() );
+
+		Entry entry;
+		entry.name.assign( nameBuffer.data(), nameLength );
+		entry.type = static_cast<GLenum>( values[ 1 ] );
+		entry.location = values[ 2 ];
 
-			lower_data++;
+		// tömböknél "nev[0]" a neve, de "nev"-vel is elérhető, mint a glGetUniformLocation-nél
+		const std::size_t arraySuffix = entry.name.rfind( "[0]" );
+		if ( arraySuffix != std::string::npos && arraySuffix + 3 == entry.name.size() )
+		{
+			m_entries.push_back( Entry{ entry.name.substr( 0, arraySuffix ), entry.location, entry.type } );
 		}
-		higher_data -= pitchInPixels;
+		m_entries.push_back( std::move( entry ) );
 	}
+
+	std::sort( m_entries.begin(), m_entries.end(), []( const Entry& a, const Entry& b ) { return a.name < b.name; } );
+}
+
+void ProgramUniforms::Clear() noexcept
+{
+	m_programID = 0;
+	m_entries.clear();
+}
+
+const ProgramUniforms::Entry* ProgramUniforms::Find( std::string_view name ) const noexcept
+{
+	auto it = std::lower_bound( m_entries.cbegin(), m_entries.cend(), name, []( const Entry& entry, std::string_view n ) { return entry.name < n; } );
+	return ( it != m_entries.cend() && it->name == name ) ? &*it : nullptr;
+}
+
+void ProgramUniforms::ReportTypeMismatch( std::string_view name ) const
+{
+	SDL_LogMessage( SDL_LOG_CATEGORY_ERROR,
+					SDL_LOG_PRIORITY_ERROR,
+					"[ProgramUniforms] Uniform '%.*s' of program %u has a different type than requested.",
+					static_cast<int>( name.size() ), name.data(), m_programID );
+}
+
+bool HasDirectStateAccess()
+{
+	// a DSA-s glNamedBufferStorage / glTextureStorage2D a buffer_storage és texture_storage tárat használja
+	static const bool available = GLEW_VERSION_4_5 ||
+		( GLEW_ARB_direct_state_access && GLEW_ARB_buffer_storage && GLEW_ARB_texture_storage );
+	return available;
+}
+
+GLuint CreateTexture( GLenum Target )
+{
+	GLuint textureID = 0;
+	if ( HasDirectStateAccess() )
+		glCreateTextures( Target, 1, &textureID );
+	else
+		glGenTextures( 1, &textureID );
+	return textureID;
+}
+
+// a teljes mipmap lánc szintjeinek száma (1x1-ig)
+static GLsizei MipLevelCount( GLsizei width, GLsizei height )
+{
+	GLsizei levels = 1;
+	for ( GLsizei size = std::max( width, height ); size > 1; size /= 2 ) ++levels;
+	return levels;
 }
 
 void TextureFromFile( const GLuint tex, const std::filesystem::path& fileName, GLenum Type, GLenum Role )
@@ -186,7 +310,19 @@ void TextureFromFile( const GLuint tex, const std::filesystem::path& fileName, G
 
 	// Áttérés SDL koordinátarendszerről ( (0,0) balfent ) OpenGL textúra-koordinátarendszerre ( (0,0) ballent )
 	if ( Type != GL_TEXTURE_CUBE_MAP && Type != GL_TEXTURE_CUBE_MAP_ARRAY )
-		invert_image_RGBA( formattedSurf->pitch / sizeof( Uint32 ), formattedSurf->h, reinterpret_cast<Uint32*>( formattedSurf->pixels ) );
+		invert_image_RGBA( formattedSurf->pitch / sizeof( Uint32 ), formattedSurf->h, reinterpret_cast<std::uint32_t*>( formattedSurf->pixels ) );
+
+	// A glGenTextures-es név csak az első kötéskor lesz objektum (glIsTexture hamis), a DSA hívások addig hibát adnak.
+	// A kocka oldalait egyenként kapjuk, azokhoz nem lehet itt egyszerre megváltoztathatatlan tárat foglalni.
+	if ( HasDirectStateAccess() && Type == GL_TEXTURE_2D && Role == Type && glIsTexture( tex ) )
+	{
+		// a SetupTextureSampling a többi mipmap szintet is kitölti, ezért a teljes láncnak foglalunk
+		glTextureStorage2D( tex, MipLevelCount( formattedSurf->w, formattedSurf->h ), GL_RGBA8, formattedSurf->w, formattedSurf->h );
+		glTextureSubImage2D( tex, 0, 0, 0, formattedSurf->w, formattedSurf->h, GL_RGBA, GL_UNSIGNED_BYTE, formattedSurf->pixels );
+
+		SDL_FreeSurface( formattedSurf );
+		return;
+	}
 
 	glBindTexture(Type, tex);
 	glTexImage2D(
@@ -208,6 +344,17 @@ void TextureFromFile( const GLuint tex, const std::filesystem::path& fileName, G
 
 void SetupTextureSampling( GLenum Target, GLuint textureID, bool generateMipMap )
 {
+	// DSA-val kötés nélkül; a glIsTexture ugyanazért kell, mint a TextureFromFile-ban
+	if ( HasDirectStateAccess() && glIsTexture( textureID ) )
+	{
+		if ( generateMipMap ) glGenerateTextureMipmap( textureID );
+		glTextureParameteri( textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTextureParameteri( textureID, GL_TEXTURE_MIN_FILTER, generateMipMap ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+		glTextureParameteri( textureID, GL_TEXTURE_WRAP_S, GL_REPEAT );
+		glTextureParameteri( textureID, GL_TEXTURE_WRAP_T, GL_REPEAT );
+		return;
+	}
+
 	// mintavételezés beállításai
 	glBindTexture( Target, textureID );
 	if ( generateMipMap ) glGenerateMipmap( Target ); // Mipmap generálása
@@ -219,12 +366,20 @@ void SetupTextureSampling( GLenum Target, GLuint textureID, bool generateMipMap
 	glBindTexture( Target, 0 );
 }
 
-void CleanOGLObject( OGLObject& ObjectGPU )
+const void* NarrowIndices( const std::uint32_t* indices, std::size_t indexCount, GLenum indexType, std::vector<GLushort>& scratch )
 {
-	glDeleteBuffers(1,      &ObjectGPU.vboID);
-	ObjectGPU.vboID = 0;
-	glDeleteBuffers(1,      &ObjectGPU.iboID);
-	ObjectGPU.iboID = 0;
-	glDeleteVertexArrays(1, &ObjectGPU.vaoID);
-	ObjectGPU.vaoID = 0;
-}
\ No newline at end of file
+	if ( indexType == GL_UNSIGNED_INT ) return indices;
+
+	// a csonkolás a 0xffffffff-ből 0xffff-et csinál, így a sávok elválasztója is megmarad
+	scratch.resize( indexCount );
+	for ( std::size_t i = 0; i < indexCount; ++i ) scratch[ i ] = static_cast<GLushort>( indices[ i ] );
+	return scratch.data();
+}
+
+GLuint CreateImmutableBuffer( GLsizeiptr size, const void* data, GLbitfield flags )
+{
+	GLuint bufferID = 0;
+	glCreateBuffers( 1, &bufferID );
+	glNamedBufferStorage( bufferID, std::max<GLsizeiptr>( size, 1 ), size > 0 ? data : nullptr, flags );
+	return bufferID;
+}
@@ -1,10 +1,16 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "MeshObject.hpp"
+#include "MeshPacking.hpp"
 
 /* 
 
@@ -12,55 +18,128 @@ Az http://www.opengl-tutorial.org/ oldal alapján.
 
 */
 
-// Segéd osztályok
-
-struct VertexPosColor
+// Uniform változó helye, a típusával együtt, hogy a SetUniform csak a megfelelő glUniform* hívást engedje
+template <typename T>
+struct UniformHandle
 {
-    glm::vec3 position;
-    glm::vec3 color;
+	GLint location = -1; // -1: nincs ilyen aktív uniform, a glUniform* hívás ekkor nem csinál semmit
 };
 
-struct VertexPosTex
+// a C++ típushoz tartozó GLSL uniform típus(ok)
+template <typename T> struct UniformGLType;
+template <> struct UniformGLType<GLint>     { static bool Matches( GLenum type ) noexcept; }; // int és sampler
+template <> struct UniformGLType<GLuint>    { static bool Matches( GLenum type ) noexcept { return type == GL_UNSIGNED_INT; } };
+template <> struct UniformGLType<GLfloat>   { static bool Matches( GLenum type ) noexcept { return type == GL_FLOAT; } };
+template <> struct UniformGLType<glm::vec3> { static bool Matches( GLenum type ) noexcept { return type == GL_FLOAT_VEC3; } };
+template <> struct UniformGLType<glm::vec4> { static bool Matches( GLenum type ) noexcept { return type == GL_FLOAT_VEC4; } };
+template <> struct UniformGLType<glm::mat4> { static bool Matches( GLenum type ) noexcept { return type == GL_FLOAT_MAT4; } };
+
+// Egy program aktív uniformjai (név -> hely, típus), a linkelés után egyszer lekérdezve.
+// A program újralinkelése vagy törlése után érvénytelen: újra kell tölteni (Reflect), a handle-ökkel együtt.
+class ProgramUniforms
 {
-    glm::vec3 position;
-    glm::vec2 texcoord;
-};
+public:
+	void Reflect( GLuint programID );
+	void Clear() noexcept;
 
-struct Vertex
-{
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec2 texcoord;
+	GLuint ProgramID() const noexcept { return m_programID; }
+
+	// Típusos handle; ha a név nem aktív, vagy a típusa más, -1 helyű handle (eltérő típusnál hibaüzenettel)
+	template <typename T>
+	UniformHandle<T> Get( std::string_view name ) const
+	{
+		const Entry* entry = Find( name );
+		if ( entry == nullptr ) return {};
+		if ( !UniformGLType<T>::Matches( entry->type ) )
+		{
+			ReportTypeMismatch( name );
+			return {};
+		}
+		return { entry->location };
+	}
+
+private:
+	struct Entry
+	{
+		std::string name;
+		GLint       location = -1;
+		GLenum      type = GL_NONE;
+	};
+
+	const Entry* Find( std::string_view name ) const noexcept;
+	void ReportTypeMismatch( std::string_view name ) const;
+
+	GLuint             m_programID = 0;
+	std::vector<Entry> m_entries; // név szerint rendezve
 };
 
+inline void SetUniform( UniformHandle<GLint> uniform, GLint value )                  { glUniform1i( uniform.location, value ); }
+inline void SetUniform( UniformHandle<GLuint> uniform, GLuint value )                { glUniform1ui( uniform.location, value ); }
+inline void SetUniform( UniformHandle<GLfloat> uniform, GLfloat value )              { glUniform1f( uniform.location, value ); }
+inline void SetUniform( UniformHandle<GLfloat> uniform, const GLfloat* values, GLsizei count ) { glUniform1fv( uniform.location, count, values ); } // tömb
+inline void SetUniform( UniformHandle<glm::vec3> uniform, const glm::vec3& value )   { glUniform3fv( uniform.location, 1, glm::value_ptr( value ) ); }
+inline void SetUniform( UniformHandle<glm::vec4> uniform, const glm::vec4& value )   { glUniform4fv( uniform.location, 1, glm::value_ptr( value ) ); }
+inline void SetUniform( UniformHandle<glm::vec4> uniform, const glm::vec4* values, GLsizei count ) { glUniform4fv( uniform.location, count, glm::value_ptr( values[ 0 ] ) ); } // tömb
+inline void SetUniform( UniformHandle<glm::mat4> uniform, const glm::mat4& value )   { glUniformMatrix4fv( uniform.location, 1, GL_FALSE, glm::value_ptr( value ) ); }
+
 // Segéd függvények
 
+// Elérhető-e a GL 4.5 Direct State Access a megváltoztathatatlan (immutable) puffer- és textúratárral.
+// Ha igen, a feltöltő függvények kötés nélkül, glCreate* / glNamed*Storage hívásokkal dolgoznak, különben a régi,
+// kötéses úton. Csak a glewInit után hívható; az első hívás eredményét megjegyzi.
+bool HasDirectStateAccess();
+
 void loadShader( const GLuint loadedShader, const std::filesystem::path& _fileName );
 void compileShaderFromSource( const GLuint loadedShader, std::string_view shaderCode );
 
-void AssembleProgram( const GLuint programID, const std::filesystem::path& vs_filename, const std::filesystem::path& fs_filename );
+// A visszaadott tábla a sikeresen linkelt program aktív uniformjai (sikertelen linkelésnél üres)
+ProgramUniforms AssembleProgram( const GLuint programID, const std::filesystem::path& vs_filename, const std::filesystem::path& fs_filename );
+ProgramUniforms AssembleComputeProgram( const GLuint programID, const std::filesystem::path& cs_filename );
 
+// a glDraw*Indirect parancsok puffer-beli formátuma
+// https://registry.khronos.org/OpenGL-Refpages/gl4/html/glDrawElementsIndirect.xhtml
+struct DrawElementsIndirectCommand
+{
+	GLuint count = 0;
+	GLuint instanceCount = 0;
+	GLuint firstIndex = 0;
+	GLint  baseVertex = 0;
+	GLuint baseInstance = 0;
+};
+static_assert( sizeof( DrawElementsIndirectCommand ) == 5 * sizeof( GLuint ) );
+
+// Új textúra név; DSA-val (glCreateTextures) már létező, Target típusú objektum, így a TextureFromFile
+// megváltoztathatatlan tárat foglalhat neki. DSA nélkül glGenTextures.
+[[nodiscard]] GLuint CreateTexture( GLenum Target );
+
+// 2D textúránál, ha a tex már létező objektum (CreateTexture) és van DSA, megváltoztathatatlan tárat foglal
+// a teljes mipmap lánccal (glTextureStorage2D); egyébként (kocka oldalai, glGenTextures-es név) glTexImage2D.
 void TextureFromFile( const GLuint tex, const std::filesystem::path& fileName, GLenum Type, GLenum Role );
 
 inline void TextureFromFile( const GLuint tex, const std::filesystem::path& fileName, GLenum Type = GL_TEXTURE_2D ) { TextureFromFile( tex, fileName, Type, Type ); }
 
 void SetupTextureSampling( GLenum Target, GLuint textureID, bool generateMipMap = true );
 
-template<typename VertexT>
-struct MeshObject
+// A legkeskenyebb index típus a csúcsok számához (MinimalIndexSize), és a mérete bájtban
+inline GLenum IndexType( std::size_t vertexCount ) noexcept
 {
-    std::vector<VertexT> vertexArray;
-    std::vector<GLuint>  indexArray;
-};
+	return MinimalIndexSize( vertexCount ) == sizeof( GLushort ) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
 
-struct OGLObject
+inline std::size_t IndexTypeSize( GLenum indexType ) noexcept
 {
-    GLuint  vaoID = 0; // vertex array object erőforrás azonosító
-    GLuint  vboID = 0; // vertex buffer object erőforrás azonosító
-    GLuint  iboID = 0; // index buffer object erőforrás azonosító
-    GLsizei count = 0; // mennyi indexet/vertexet kell rajzolnunk
-};
+	return indexType == GL_UNSIGNED_SHORT ? sizeof( GLushort ) : sizeof( GLuint );
+}
+
+// Az indexek indexType szélességűre alakítva (a PRIMITIVE_RESTART_INDEX-ből a típus legnagyobb értéke lesz).
+// GL_UNSIGNED_INT-nél az eredeti tömböt adja vissza, különben a scratch-be ír.
+const void* NarrowIndices( const std::uint32_t* indices, std::size_t indexCount, GLenum indexType, std::vector<GLushort>& scratch );
 
+// MeshTopology -> a glDraw* hívások mode paramétere
+inline GLenum PrimitiveType( MeshTopology topology ) noexcept
+{
+	return topology == MeshTopology::TriangleStrip ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+}
 
 struct VertexAttributeDescriptor
 {
@@ -68,54 +147,12 @@ struct VertexAttributeDescriptor
 	std::uintptr_t strideInBytes = 0;
 	GLint          numberOfComponents = 0;
 	GLenum         glType = GL_NONE;
+	GLboolean      normalized = GL_FALSE; // egész típusoknál: [0, 1]-be / [-1, 1]-be képezve érkezik a shaderbe
 };
 
-template <typename VertexT>
-[[nodiscard]] OGLObject CreateGLObjectFromMesh( const MeshObject<VertexT>& mesh, std::initializer_list<VertexAttributeDescriptor> vertexAttrDescList )
-{
-	OGLObject meshGPU = { 0 };
-
-	// 1 db VAO foglalasa
-	glGenVertexArrays(1, &meshGPU.vaoID);
-	// a frissen generált VAO beallitasa aktívnak
-	glBindVertexArray(meshGPU.vaoID);
-
-	// hozzunk létre egy új VBO erőforrás nevet
-	glGenBuffers(1, &meshGPU.vboID);
-	glBindBuffer(GL_ARRAY_BUFFER, meshGPU.vboID); // tegyük "aktívvá" a létrehozott VBO-t
-
-	// töltsük fel adatokkal az aktív VBO-t
-	glBufferData(GL_ARRAY_BUFFER,	// az aktív VBO-ba töltsünk adatokat
-				  mesh.vertexArray.size() * sizeof(VertexT),		// ennyi bájt nagyságban
-				  mesh.vertexArray.data(),	// erről a rendszermemóriabeli címről olvasva
-				  GL_STATIC_DRAW);	// úgy, hogy a VBO-nkba nem tervezünk ezután írni és minden kirajzoláskor felhasnzáljuk a benne lévő adatokat
-
-	// index puffer létrehozása
-	glGenBuffers(1, &meshGPU.iboID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshGPU.iboID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indexArray.size() * sizeof(GLuint), mesh.indexArray.data(), GL_STATIC_DRAW);
-
-	meshGPU.count = static_cast<GLsizei>(mesh.indexArray.size());
-
-	for ( const auto& vertexAttrDesc: vertexAttrDescList )
-	{
-		glEnableVertexAttribArray(vertexAttrDesc.index); // ez lesz majd a pozíció
-		glVertexAttribPointer(
-			vertexAttrDesc.index,				  // a VB-ben található adatok közül a 0. "indexű" attribútumait állítjuk be
-			vertexAttrDesc.numberOfComponents,	  // komponens szam
-			vertexAttrDesc.glType,				  // adatok tipusa
-			GL_FALSE,							  // normalizalt legyen-e
-			sizeof(VertexT),					  // stride (0=egymas utan)
-			reinterpret_cast<const void*>(vertexAttrDesc.strideInBytes) // a 0. indexű attribútum hol kezdődik a sizeof(Vertex)-nyi területen belül
-		);
-	}
-
-	glBindVertexArray(0); // feltöltüttük a VAO-t, kapcsoljuk le
-	glBindBuffer(GL_ARRAY_BUFFER, 0); // feltöltöttük a VBO-t is, ezt is vegyük le
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-	return meshGPU;
-}
-
-void CleanOGLObject( OGLObject& ObjectGPU );
+// a VBO kötési pontja a VAO-ban (glVertexArrayVertexBuffer), minden attribútum ebből olvas
+constexpr GLuint MESH_VERTEX_BUFFER_BINDING = 0;
 
+// size bájtos megváltoztathatatlan tárú puffer (glNamedBufferStorage) data tartalommal; flags: GL_*_STORAGE_BIT-ek.
+// Üres adatnál is legalább 1 bájtot foglal, mert a 0 méret hiba.
+[[nodiscard]] GLuint CreateImmutableBuffer( GLsizeiptr size, const void* data, GLbitfield flags );
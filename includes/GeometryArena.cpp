@@ -0,0 +1,206 @@
+#include "GeometryArena.hpp"
+
+#include <algorithm>
+
+#include <SDL2/SDL.h>
+
+DrawElementsIndirectCommand DrawCommand( const GeometryRange& range, GLuint instanceCount, GLuint baseInstance ) noexcept
+{
+	DrawElementsIndirectCommand command;
+	command.count = range.indexCount;
+	command.instanceCount = range.indexCount > 0 ? instanceCount : 0;
+	command.firstIndex = range.firstIndex;
+	command.baseVertex = range.baseVertex;
+	command.baseInstance = baseInstance;
+	return command;
+}
+
+// newSize bájtos írható puffer, az oldBufferID első oldSize bájtjával; a régi puffer törlődik
+static GLuint ResizeBuffer( GLuint oldBufferID, GLsizeiptr oldSize, GLsizeiptr newSize )
+{
+	GLuint bufferID = 0;
+	if ( HasDirectStateAccess() )
+	{
+		bufferID = CreateImmutableBuffer( newSize, nullptr, GL_DYNAMIC_STORAGE_BIT );
+		if ( oldSize > 0 ) glCopyNamedBufferSubData( oldBufferID, bufferID, 0, 0, oldSize );
+	}
+	else
+	{
+		// a másolás célpontjai nem VAO állapotok, így a kötésük semmit nem ront el
+		glGenBuffers( 1, &bufferID );
+		glBindBuffer( GL_COPY_WRITE_BUFFER, bufferID );
+		glBufferData( GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_DYNAMIC_DRAW );
+		if ( oldSize > 0 )
+		{
+			glBindBuffer( GL_COPY_READ_BUFFER, oldBufferID );
+			glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize );
+			glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+		}
+		glBindBuffer( GL_COPY_WRITE_BUFFER, 0 );
+	}
+	glDeleteBuffers( 1, &oldBufferID );
+	return bufferID;
+}
+
+static void WriteBuffer( GLuint bufferID, GLintptr offset, GLsizeiptr size, const void* data )
+{
+	if ( size == 0 ) return;
+
+	if ( HasDirectStateAccess() )
+	{
+		glNamedBufferSubData( bufferID, offset, size, data );
+		return;
+	}
+	// az IBO-t is a GL_ARRAY_BUFFER-en át írjuk: a GL_ELEMENT_ARRAY_BUFFER kötése a VAO állapota lenne
+	glBindBuffer( GL_ARRAY_BUFFER, bufferID );
+	glBufferSubData( GL_ARRAY_BUFFER, offset, size, data );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+}
+
+void GeometryArena::Init( std::initializer_list<VertexAttributeDescriptor> vertexAttrDescList, GLsizei vertexStride, GLenum indexType,
+						  std::size_t vertexCapacity, std::size_t indexCapacity )
+{
+	m_vertexStride = vertexStride;
+	m_indexType = indexType;
+	m_vertices = RangeAllocator( vertexCapacity );
+	m_indices = RangeAllocator( indexCapacity );
+
+	m_vboID = ResizeBuffer( 0, 0, static_cast<GLsizeiptr>( vertexCapacity * vertexStride ) );
+	m_iboID = ResizeBuffer( 0, 0, static_cast<GLsizeiptr>( indexCapacity * IndexTypeSize( indexType ) ) );
+
+	// a formátum a kötési ponté (MESH_VERTEX_BUFFER_BINDING), nem a puffereké: növeléskor elég a puffert újrakötni
+	if ( HasDirectStateAccess() )
+	{
+		glCreateVertexArrays( 1, &m_vaoID );
+		for ( const auto& vertexAttrDesc : vertexAttrDescList )
+		{
+			glEnableVertexArrayAttrib( m_vaoID, vertexAttrDesc.index );
+			glVertexArrayAttribFormat( m_vaoID, vertexAttrDesc.index, vertexAttrDesc.numberOfComponents, vertexAttrDesc.glType,
+									   vertexAttrDesc.normalized, static_cast<GLuint>( vertexAttrDesc.strideInBytes ) );
+			glVertexArrayAttribBinding( m_vaoID, vertexAttrDesc.index, MESH_VERTEX_BUFFER_BINDING );
+		}
+	}
+	else
+	{
+		glGenVertexArrays( 1, &m_vaoID );
+		glBindVertexArray( m_vaoID );
+		for ( const auto& vertexAttrDesc : vertexAttrDescList )
+		{
+			glEnableVertexAttribArray( vertexAttrDesc.index );
+			glVertexAttribFormat( vertexAttrDesc.index, vertexAttrDesc.numberOfComponents, vertexAttrDesc.glType,
+								  vertexAttrDesc.normalized, static_cast<GLuint>( vertexAttrDesc.strideInBytes ) );
+			glVertexAttribBinding( vertexAttrDesc.index, MESH_VERTEX_BUFFER_BINDING );
+		}
+		glBindVertexArray( 0 );
+	}
+
+	AttachBuffers();
+}
+
+void GeometryArena::Clean()
+{
+	glDeleteVertexArrays( 1, &m_vaoID );
+	glDeleteBuffers( 1, &m_vboID );
+	glDeleteBuffers( 1, &m_iboID );
+	m_vaoID = m_vboID = m_iboID = 0;
+
+	m_vertices = RangeAllocator();
+	m_indices = RangeAllocator();
+}
+
+void GeometryArena::AttachBuffers()
+{
+	if ( HasDirectStateAccess() )
+	{
+		glVertexArrayVertexBuffer( m_vaoID, MESH_VERTEX_BUFFER_BINDING, m_vboID, 0, m_vertexStride );
+		glVertexArrayElementBuffer( m_vaoID, m_iboID );
+		return;
+	}
+	glBindVertexArray( m_vaoID );
+	glBindVertexBuffer( MESH_VERTEX_BUFFER_BINDING, m_vboID, 0, m_vertexStride );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_iboID );
+	glBindVertexArray( 0 );
+}
+
+std::size_t GeometryArena::Allocate( RangeAllocator& allocator, GLuint& bufferID, std::size_t elementSize, std::size_t count )
+{
+	const std::size_t offset = allocator.Allocate( count );
+	if ( offset != RangeAllocator::INVALID ) return offset;
+
+	const std::size_t oldCapacity = allocator.Capacity();
+	const std::size_t newCapacity = std::max( 2 * oldCapacity, oldCapacity + count );
+	bufferID = ResizeBuffer( bufferID, static_cast<GLsizeiptr>( oldCapacity * elementSize ), static_cast<GLsizeiptr>( newCapacity * elementSize ) );
+	allocator.Grow( newCapacity );
+	AttachBuffers();
+
+	return allocator.Allocate( count );
+}
+
+void GeometryArena::WidenIndices()
+{
+	// a 16 bites tartalom visszaolvasva; a szabad részek szemetet tartalmaznak, az átalakításuk nem árt
+	const std::size_t capacity = m_indices.Capacity();
+	std::vector<GLushort> narrowIndices( capacity );
+	if ( HasDirectStateAccess() )
+	{
+		glGetNamedBufferSubData( m_iboID, 0, static_cast<GLsizeiptr>( capacity * sizeof( GLushort ) ), narrowIndices.data() );
+	}
+	else
+	{
+		glBindBuffer( GL_COPY_READ_BUFFER, m_iboID );
+		glGetBufferSubData( GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>( capacity * sizeof( GLushort ) ), narrowIndices.data() );
+		glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+	}
+
+	// 16 biten a 0xffff mindig a sávok elválasztója (a hálók legfeljebb 0xffff csúcsúak, az utolsó index 0xfffe)
+	std::vector<GLuint> wideIndices( capacity );
+	for ( std::size_t i = 0; i < capacity; ++i )
+	{
+		wideIndices[ i ] = narrowIndices[ i ] == 0xffff ? PRIMITIVE_RESTART_INDEX : narrowIndices[ i ];
+	}
+
+	m_indexType = GL_UNSIGNED_INT;
+	m_iboID = ResizeBuffer( m_iboID, 0, static_cast<GLsizeiptr>( capacity * sizeof( GLuint ) ) );
+	WriteBuffer( m_iboID, 0, static_cast<GLsizeiptr>( capacity * sizeof( GLuint ) ), wideIndices.data() );
+	AttachBuffers();
+}
+
+void GeometryArena::Write( GeometryRange& range, const void* vertices, std::size_t vertexSize, std::size_t vertexCount,
+						   const std::uint32_t* indices, std::size_t indexCount, MeshTopology topology )
+{
+	if ( vertexSize != static_cast<std::size_t>( m_vertexStride ) )
+	{
+		SDL_LogMessage( SDL_LOG_CATEGORY_ERROR,
+						SDL_LOG_PRIORITY_ERROR,
+						"[GeometryArena] Mesh with %zu byte vertices does not fit the arena's %d byte vertex format.",
+						vertexSize, static_cast<int>( m_vertexStride ) );
+		Remove( range );
+		return;
+	}
+	if ( IndexTypeSize( ::IndexType( vertexCount ) ) > IndexTypeSize( m_indexType ) ) WidenIndices(); // a GLUtils-beli, a vertexCount-hoz elég típus
+
+	if ( vertexCount > range.vertexCapacity || indexCount > range.indexCapacity )
+	{
+		Remove( range );
+		range.baseVertex = static_cast<GLint>( Allocate( m_vertices, m_vboID, vertexSize, vertexCount ) );
+		range.firstIndex = static_cast<GLuint>( Allocate( m_indices, m_iboID, IndexTypeSize( m_indexType ), indexCount ) );
+		range.vertexCapacity = static_cast<GLuint>( vertexCount );
+		range.indexCapacity = static_cast<GLuint>( indexCount );
+	}
+
+	range.vertexCount = static_cast<GLuint>( vertexCount );
+	range.indexCount = static_cast<GLuint>( indexCount );
+	range.primitiveType = PrimitiveType( topology );
+
+	const std::size_t indexSize = IndexTypeSize( m_indexType );
+	WriteBuffer( m_vboID, static_cast<GLintptr>( range.baseVertex * vertexSize ), static_cast<GLsizeiptr>( vertexCount * vertexSize ), vertices );
+	WriteBuffer( m_iboID, static_cast<GLintptr>( range.firstIndex * indexSize ), static_cast<GLsizeiptr>( indexCount * indexSize ),
+				 NarrowIndices( indices, indexCount, m_indexType, m_narrowIndices ) );
+}
+
+void GeometryArena::Remove( GeometryRange& range )
+{
+	m_vertices.Free( static_cast<std::size_t>( range.baseVertex ), range.vertexCapacity );
+	m_indices.Free( range.firstIndex, range.indexCapacity );
+	range = GeometryRange();
+}
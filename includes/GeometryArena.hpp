@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "GLUtils.hpp"
+#include "MeshObject.hpp"
+#include "MeshPacking.hpp"
+#include "RangeAllocator.hpp"
+
+// Egy háló helye a GeometryArena közös puffereiben
+struct GeometryRange
+{
+	GLint  baseVertex = 0;     // az első csúcs helye a VBO-ban; a háló indexei ehhez képest 0-tól számoznak
+	GLuint firstIndex = 0;     // az első index helye az IBO-ban
+	GLuint vertexCount = 0;
+	GLuint indexCount = 0;     // 0: üres (nincs feltöltve, vagy nem fért el)
+	GLuint vertexCapacity = 0; // a lefoglalt hely, eddig helyben frissíthető
+	GLuint indexCapacity = 0;
+	GLenum primitiveType = GL_TRIANGLES;
+
+	PositionQuantization quantization; // VertexPacked csúcsoknál a world mátrix jobb oldalára kell szorozni a Matrix()-át
+};
+
+// instanceCount példány baseInstance-tól a range hálójából, a glMultiDrawElementsIndirect parancs pufferébe
+DrawElementsIndirectCommand DrawCommand( const GeometryRange& range, GLuint instanceCount, GLuint baseInstance ) noexcept;
+
+// Geometria aréna: az összes azonos csúcsformátumú háló egy közös VBO-ban és IBO-ban, egyetlen VAO-val.
+// A hálók helyét (base vertex, first index) RangeAllocator osztja ki, így egy parancspufferrel az egész
+// színtér kirajzolható egy glMultiDrawElementsIndirect hívással, objektumonkénti VAO váltás nélkül.
+// Ha egy háló nem fér el, a pufferek legalább duplájukra nőnek (a tartalmuk átmásolódik, a range-ek érvényesek maradnak).
+// Ha egy háló csúcsai 16 bites indexszel nem címezhetők, az IBO 32 bitesre vált (a range-ek ekkor is érvényesek, de az
+// IndexType() megváltozik, ezért a rajzoláskor mindig onnan kell venni).
+class GeometryArena
+{
+public:
+	// a VAO attribútumai (vertexAttribList / vertexPackedAttribList); indexType az összes hálóra közös kezdő index típus
+	void Init( std::initializer_list<VertexAttributeDescriptor> vertexAttrDescList, GLsizei vertexStride, GLenum indexType,
+			   std::size_t vertexCapacity, std::size_t indexCapacity );
+	void Clean();
+
+	[[nodiscard]] GeometryRange Add( const PackedMesh& packedMesh )
+	{
+		GeometryRange range;
+		Update( range, packedMesh );
+		return range;
+	}
+
+	// A háló feltöltése a range helyére, ha belefér, különben új helyre (a régit felszabadítva); üres range-re Add.
+	// Más csúcsméretű hálónál hibát jelez, és a range üres lesz.
+	template <typename VertexT>
+	void Update( GeometryRange& range, const MeshView<VertexT>& mesh )
+	{
+		Write( range, mesh.vertices, sizeof( VertexT ), mesh.vertexCount, mesh.indices, mesh.indexCount, mesh.topology );
+	}
+
+	void Update( GeometryRange& range, const PackedMesh& packedMesh )
+	{
+		Update( range, MeshView<VertexPacked>( packedMesh.mesh ) );
+		range.quantization = packedMesh.quantization;
+	}
+
+	void Remove( GeometryRange& range ); // a helye felszabadul, a range üres lesz
+
+	GLuint VaoID() const noexcept { return m_vaoID; }
+	GLenum IndexType() const noexcept { return m_indexType; }
+
+private:
+	void Write( GeometryRange& range, const void* vertices, std::size_t vertexSize, std::size_t vertexCount,
+				const std::uint32_t* indices, std::size_t indexCount, MeshTopology topology );
+	std::size_t Allocate( RangeAllocator& allocator, GLuint& bufferID, std::size_t elementSize, std::size_t count );
+	void AttachBuffers(); // a VBO és az IBO (újra)kötése a VAO-hoz
+	void WidenIndices();  // a GL_UNSIGNED_SHORT IBO cseréje GL_UNSIGNED_INT-re, a tartalmával együtt
+
+	GLuint  m_vaoID = 0;
+	GLuint  m_vboID = 0;
+	GLuint  m_iboID = 0;
+	GLsizei m_vertexStride = 0;
+	GLenum  m_indexType = GL_UNSIGNED_INT;
+
+	RangeAllocator        m_vertices; // csúcsokban
+	RangeAllocator        m_indices;  // indexekben
+	std::vector<GLushort> m_narrowIndices; // a NarrowIndices átmeneti tömbje, hálóról hálóra újrahasznosítva
+};
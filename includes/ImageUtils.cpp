@@ -0,0 +1,21 @@
+#include "ImageUtils.hpp"
+
+void invert_image_RGBA(int pitchInPixels, int height, std::uint32_t* image_pixels)
+{
+	int height_div_2 = height / 2;
+	std::uint32_t* lower_data  =image_pixels;
+	std::uint32_t* higher_data =image_pixels + ( height - 1 ) * pitchInPixels;
+
+	for ( int index = 0; index < height_div_2; index++ )
+	{
+		for ( int rowIndex = 0; rowIndex < pitchInPixels; rowIndex++ )
+		{
+			*lower_data ^= higher_data[ rowIndex ];
+			higher_data[ rowIndex ] ^= *lower_data;
+			*lower_data ^= higher_data[ rowIndex ];
+
+			lower_data++;
+		}
+		higher_data -= pitchInPixels;
+	}
+}
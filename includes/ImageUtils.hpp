@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// SDL-től független képművelet, hogy GL kontextus nélkül is mérhető legyen (lásd bench/).
+
+// A kép sorainak függőleges tükrözése helyben: SDL koordinátarendszer ( (0,0) balfent ) -> OpenGL ( (0,0) ballent )
+void invert_image_RGBA( int pitchInPixels, int height, std::uint32_t* image_pixels );
@@ -0,0 +1,140 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile::MappedFile( MappedFile&& other ) noexcept
+{
+	*this = std::move( other );
+}
+
+MappedFile& MappedFile::operator=( MappedFile&& other ) noexcept
+{
+	if ( this != &other )
+	{
+		Close();
+		std::swap( m_data, other.m_data );
+		std::swap( m_size, other.m_size );
+		std::swap( m_isOpen, other.m_isOpen );
+#ifdef _WIN32
+		std::swap( m_mappingHandle, other.m_mappingHandle );
+#endif
+	}
+	return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open( const std::filesystem::path& fileName )
+{
+	Close();
+
+	// FILE_FLAG_SEQUENTIAL_SCAN: az előreolvasás agresszívabb, mint véletlen elérésnél
+	HANDLE fileHandle = CreateFileW( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+									 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if ( fileHandle == INVALID_HANDLE_VALUE ) return false;
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( fileHandle, &fileSize ) )
+	{
+		CloseHandle( fileHandle );
+		return false;
+	}
+
+	if ( fileSize.QuadPart == 0 ) // üres fájl nem képezhető le
+	{
+		CloseHandle( fileHandle );
+		m_isOpen = true;
+		return true;
+	}
+
+	HANDLE mappingHandle = CreateFileMappingW( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	CloseHandle( fileHandle ); // a leképzés életben tartja a fájlt
+	if ( mappingHandle == nullptr ) return false;
+
+	const void* view = MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+	if ( view == nullptr )
+	{
+		CloseHandle( mappingHandle );
+		return false;
+	}
+
+	m_data = static_cast<const char*>( view );
+	m_size = static_cast<std::size_t>( fileSize.QuadPart );
+	m_mappingHandle = mappingHandle;
+	m_isOpen = true;
+	return true;
+}
+
+void MappedFile::Close() noexcept
+{
+	if ( m_data != nullptr ) UnmapViewOfFile( m_data );
+	if ( m_mappingHandle != nullptr ) CloseHandle( m_mappingHandle );
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mappingHandle = nullptr;
+	m_isOpen = false;
+}
+
+#else
+
+bool MappedFile::Open( const std::filesystem::path& fileName )
+{
+	Close();
+
+	const int fd = ::open( fileName.c_str(), O_RDONLY | O_CLOEXEC );
+	if ( fd < 0 ) return false;
+
+	struct stat fileStat;
+	if ( ::fstat( fd, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+	{
+		::close( fd );
+		return false;
+	}
+
+	if ( fileStat.st_size == 0 ) // üres fájl nem képezhető le
+	{
+		::close( fd );
+		m_isOpen = true;
+		return true;
+	}
+
+	void* view = ::mmap( nullptr, static_cast<std::size_t>( fileStat.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+	::close( fd ); // a leképzés életben tartja a fájlt
+	if ( view == MAP_FAILED ) return false;
+
+	// elejétől a végéig olvassuk: agresszív előreolvasás, a már olvasott lapok hamar eldobhatók
+	::madvise( view, static_cast<std::size_t>( fileStat.st_size ), MADV_SEQUENTIAL );
+
+	m_data = static_cast<const char*>( view );
+	m_size = static_cast<std::size_t>( fileStat.st_size );
+	m_isOpen = true;
+	return true;
+}
+
+void MappedFile::Close() noexcept
+{
+	if ( m_data != nullptr ) ::munmap( const_cast<char*>( m_data ), m_size );
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+}
+
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+// Csak olvasható, memóriába leképzett fájl (POSIX mmap / Win32 file mapping).
+// A tartalom közvetlenül a page cache-ből olvasható, nem kell bemásolni egy pufferbe.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile( MappedFile&& other ) noexcept;
+	MappedFile& operator=( MappedFile&& other ) noexcept;
+
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+
+	// false, ha a fájl nem nyitható meg vagy nem képezhető le.
+	// Üres fájlnál true, ekkor Data() == nullptr és Size() == 0.
+	bool Open( const std::filesystem::path& fileName );
+	void Close() noexcept;
+
+	bool        IsOpen() const noexcept { return m_isOpen; }
+	const char* Data() const noexcept { return m_data; }
+	std::size_t Size() const noexcept { return m_size; }
+
+private:
+	const char* m_data = nullptr;
+	std::size_t m_size = 0;
+	bool        m_isOpen = false;
+#ifdef _WIN32
+	void*       m_mappingHandle = nullptr;
+#endif
+};
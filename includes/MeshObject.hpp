@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// OpenGL-független mesh típusok, hogy a CPU oldali kód (ObjParser, GetParamSurfMesh)
+// GLEW és GL kontextus nélkül is fordítható legyen (lásd bench/).
+
+struct VertexPosColor
+{
+    glm::vec3 position;
+    glm::vec3 color;
+};
+
+struct VertexPosTex
+{
+    glm::vec3 position;
+    glm::vec2 texcoord;
+};
+
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texcoord;
+};
+
+// Tömörített csúcs (12 bájt a Vertex 32 bájtja helyett), lásd PackMesh() (MeshPacking.hpp):
+//  - position: 16 bites normalizált egészek, a mesh befoglaló dobozára skálázva (PositionQuantization),
+//  - normal:   oktaéder leképezéssel 2 darab 8 bites normalizált egészre kódolva,
+//  - texcoord: 2 darab half float.
+struct VertexPacked
+{
+    std::int16_t  position[ 3 ];
+    std::int8_t   normal[ 2 ];
+    std::uint16_t texcoord[ 2 ];
+};
+static_assert( sizeof( VertexPacked ) == 12 );
+
+// A [-1, 1]-be normalizált pozíciók visszaalakítása: position = packed * scale + offset
+struct PositionQuantization
+{
+    glm::vec3 scale = glm::vec3( 1.0f );
+    glm::vec3 offset = glm::vec3( 0.0f );
+
+    // ugyanez mátrixként, a world mátrix jobb oldalára szorozva
+    glm::mat4 Matrix() const
+    {
+        return glm::mat4( glm::vec4( scale.x, 0.0f, 0.0f, 0.0f ),
+                          glm::vec4( 0.0f, scale.y, 0.0f, 0.0f ),
+                          glm::vec4( 0.0f, 0.0f, scale.z, 0.0f ),
+                          glm::vec4( offset, 1.0f ) );
+    }
+};
+
+// Az index tömb értelmezése
+enum class MeshTopology : std::uint8_t
+{
+    TriangleList,  // háromszögenként 3 index
+    TriangleStrip, // sávok, egymástól PRIMITIVE_RESTART_INDEX-szel elválasztva
+};
+
+// A sávok elválasztója: GL_PRIMITIVE_RESTART_FIXED_INDEX mellett az index típus legnagyobb értéke
+constexpr std::uint32_t PRIMITIVE_RESTART_INDEX = ~std::uint32_t( 0 );
+
+// A legkeskenyebb index méret bájtban (2 vagy 4), amiben a mesh minden csúcsindexe elfér úgy, hogy a típus
+// legnagyobb értéke a PRIMITIVE_RESTART_INDEX-nek maradjon. 1 bájtos indexet nem választunk: sok GPU nem
+// támogatja közvetlenül (a driver alakítja át), a nyereség pedig a 256 csúcs alatti mesh-eknél elhanyagolható.
+constexpr std::size_t MinimalIndexSize( std::size_t vertexCount ) noexcept
+{
+    return vertexCount <= 0xffff ? sizeof( std::uint16_t ) : sizeof( std::uint32_t );
+}
+
+template<typename VertexT>
+struct MeshObject
+{
+    std::vector<VertexT>       vertexArray;
+    std::vector<std::uint32_t> indexArray; // GLuint-tal megegyező
+    MeshTopology               topology = MeshTopology::TriangleList;
+};
+
+// Nem birtokolt mesh adatokra (pl. memóriába leképzett mesh cache-re) mutató nézet
+template<typename VertexT>
+struct MeshView
+{
+    const VertexT*       vertices = nullptr;
+    std::size_t          vertexCount = 0;
+    const std::uint32_t* indices = nullptr;
+    std::size_t          indexCount = 0;
+    MeshTopology         topology = MeshTopology::TriangleList;
+
+    MeshView() = default;
+    MeshView( const VertexT* _vertices, std::size_t _vertexCount, const std::uint32_t* _indices, std::size_t _indexCount,
+              MeshTopology _topology = MeshTopology::TriangleList )
+        : vertices( _vertices ), vertexCount( _vertexCount ), indices( _indices ), indexCount( _indexCount ), topology( _topology ) { }
+    MeshView( const MeshObject<VertexT>& mesh )
+        : MeshView( mesh.vertexArray.data(), mesh.vertexArray.size(), mesh.indexArray.data(), mesh.indexArray.size(), mesh.topology ) { }
+};
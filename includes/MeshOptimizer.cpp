@@ -0,0 +1,287 @@
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <glm/glm.hpp>
+
+// FIFO cache időbélyegekkel: egy csúcs akkor van a cache-ben, ha a betöltése óta kevesebb mint
+// cacheSize másik csúcsot kellett betölteni.
+class FifoCacheSim
+{
+public:
+	FifoCacheSim( std::size_t vertexCount, unsigned int cacheSize )
+		: m_loadTime( vertexCount, 0 ), m_time( cacheSize + 1 ), m_cacheSize( cacheSize ) { }
+
+	// true, ha a csúcsot be kellett tölteni
+	bool Access( std::uint32_t vertex ) noexcept
+	{
+		if ( m_time - m_loadTime[ vertex ] <= m_cacheSize ) return false;
+		m_loadTime[ vertex ] = m_time++;
+		return true;
+	}
+
+	unsigned int TriangleMisses( const std::uint32_t* triangle ) noexcept
+	{
+		return Access( triangle[ 0 ] ) + Access( triangle[ 1 ] ) + Access( triangle[ 2 ] );
+	}
+
+	// minden csúcs kikerül a cache-ből
+	void Flush() noexcept { m_time += m_cacheSize + 1; }
+
+private:
+	std::vector<std::uint32_t> m_loadTime;
+	std::uint32_t              m_time;
+	unsigned int               m_cacheSize;
+};
+
+VertexCacheStats AnalyzeVertexCache( const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, unsigned int cacheSize )
+{
+	VertexCacheStats stats;
+	if ( indexCount < 3 || vertexCount == 0 ) return stats;
+
+	FifoCacheSim cache( vertexCount, cacheSize );
+	std::vector<bool> isUsed( vertexCount, false );
+	std::size_t misses = 0, usedVertexCount = 0;
+	for ( std::size_t i = 0; i < indexCount; ++i )
+	{
+		misses += cache.Access( indices[ i ] );
+		if ( !isUsed[ indices[ i ] ] )
+		{
+			isUsed[ indices[ i ] ] = true;
+			usedVertexCount++;
+		}
+	}
+
+	stats.acmr = float( misses ) / float( indexCount / 3 );
+	stats.atvr = float( misses ) / float( usedVertexCount );
+	return stats;
+}
+
+//
+// Tipsify: a háromszögeket egy "legyező" csúcs körül bocsátjuk ki, és a következő legyező csúcs
+// a most kibocsátottak közül az, amelyik még a cache-ben lesz, amikor a maradék háromszögei sorra kerülnek.
+// Ha nincs ilyen, zsákutca: a legutóbb kibocsátott, még élő csúcsok egyikére, végül bármely élő csúcsra ugrunk.
+//
+
+void OptimizeVertexCache( std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned int cacheSize,
+						  std::vector<std::uint32_t>* clusterStarts )
+{
+	if ( clusterStarts != nullptr ) clusterStarts->assign( 1, 0 );
+
+	const std::size_t triangleCount = indices.size() / 3;
+	if ( triangleCount == 0 || vertexCount == 0 ) return;
+
+	// csúcs -> háromszögek szomszédsági lista (CSR), és a még ki nem bocsátott háromszögek száma csúcsonként
+	std::vector<std::uint32_t> liveCount( vertexCount, 0 );
+	for ( std::size_t i = 0; i < triangleCount * 3; ++i ) liveCount[ indices[ i ] ]++;
+
+	std::vector<std::uint32_t> adjacencyOffset( vertexCount + 1, 0 );
+	std::partial_sum( liveCount.cbegin(), liveCount.cend(), adjacencyOffset.begin() + 1 );
+
+	std::vector<std::uint32_t> adjacency( triangleCount * 3 );
+	{
+		std::vector<std::uint32_t> fill( adjacencyOffset.cbegin(), adjacencyOffset.cend() - 1 );
+		for ( std::size_t i = 0; i < triangleCount * 3; ++i ) adjacency[ fill[ indices[ i ] ]++ ] = static_cast<std::uint32_t>( i / 3 );
+	}
+
+	std::vector<std::uint32_t> cacheTime( vertexCount, 0 );
+	std::uint32_t time = cacheSize + 1;
+
+	std::vector<bool>          isEmitted( triangleCount, false );
+	std::vector<std::uint32_t> deadEndStack;
+	deadEndStack.reserve( triangleCount * 3 );
+	std::vector<std::uint32_t> candidates;
+	std::size_t scanCursor = 0;
+
+	std::vector<std::uint32_t> result;
+	result.reserve( triangleCount * 3 );
+
+	constexpr std::uint32_t NO_VERTEX = ~std::uint32_t( 0 );
+	for ( std::uint32_t fanVertex = 0; fanVertex != NO_VERTEX; )
+	{
+		candidates.clear();
+		for ( std::uint32_t a = adjacencyOffset[ fanVertex ]; a < adjacencyOffset[ fanVertex + 1 ]; ++a )
+		{
+			const std::uint32_t triangle = adjacency[ a ];
+			if ( isEmitted[ triangle ] ) continue;
+
+			for ( std::size_t k = 0; k < 3; ++k )
+			{
+				const std::uint32_t v = indices[ triangle * 3 + k ];
+				result.push_back( v );
+				deadEndStack.push_back( v );
+				candidates.push_back( v );
+				liveCount[ v ]--;
+				if ( time - cacheTime[ v ] > cacheSize ) cacheTime[ v ] = time++;
+			}
+			isEmitted[ triangle ] = true;
+		}
+
+		// a következő legyező csúcs: amelyik a legrégebben került a cache-be, de a hátralevő
+		// háromszögeivel együtt is benne marad
+		fanVertex = NO_VERTEX;
+		std::int64_t bestPriority = -1;
+		for ( const std::uint32_t v : candidates )
+		{
+			if ( liveCount[ v ] == 0 ) continue;
+
+			std::int64_t priority = 0;
+			if ( time - cacheTime[ v ] + 2 * liveCount[ v ] <= cacheSize ) priority = time - cacheTime[ v ];
+			if ( priority > bestPriority )
+			{
+				bestPriority = priority;
+				fanVertex = v;
+			}
+		}
+
+		if ( fanVertex == NO_VERTEX )
+		{
+			while ( !deadEndStack.empty() && fanVertex == NO_VERTEX )
+			{
+				const std::uint32_t v = deadEndStack.back();
+				deadEndStack.pop_back();
+				if ( liveCount[ v ] > 0 ) fanVertex = v;
+			}
+			while ( scanCursor < vertexCount && fanVertex == NO_VERTEX )
+			{
+				const std::uint32_t v = static_cast<std::uint32_t>( scanCursor++ );
+				if ( liveCount[ v ] > 0 ) fanVertex = v;
+			}
+
+			const std::uint32_t emittedTriangles = static_cast<std::uint32_t>( result.size() / 3 );
+			if ( clusterStarts != nullptr && fanVertex != NO_VERTEX && clusterStarts->back() != emittedTriangles )
+			{
+				clusterStarts->push_back( emittedTriangles );
+			}
+		}
+	}
+
+	// a háromszögön kívüli (csonka) indexek a végén maradnak
+	result.insert( result.end(), indices.cbegin() + triangleCount * 3, indices.cend() );
+	indices.swap( result );
+}
+
+//
+// Overdraw: Sander et al. "lineáris" módszere. A klasztereket ott bontjuk tovább, ahol üres cache-sel
+// kezdve is legfeljebb threshold-szoros az ACMR, és a klasztereket a (cluster középpont - mesh középpont)
+// és a klaszter átlagos normálisának skalárszorzata szerint csökkenő sorrendbe tesszük.
+//
+
+void OptimizeOverdraw( std::vector<std::uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& clusterStarts,
+					   float threshold, unsigned int cacheSize )
+{
+	const std::size_t triangleCount = indices.size() / 3;
+	if ( triangleCount == 0 || vertices.empty() ) return;
+
+	// klaszterek tovább bontása
+	std::vector<std::uint32_t> clusters;
+	{
+		FifoCacheSim cache( vertices.size(), cacheSize );
+		for ( std::size_t c = 0; c < clusterStarts.size(); ++c )
+		{
+			const std::size_t begin = clusterStarts[ c ];
+			const std::size_t end = c + 1 < clusterStarts.size() ? clusterStarts[ c + 1 ] : triangleCount;
+
+			cache.Flush();
+			std::size_t clusterMisses = 0;
+			for ( std::size_t t = begin; t < end; ++t ) clusterMisses += cache.TriangleMisses( &indices[ t * 3 ] );
+			const float clusterThreshold = threshold * float( clusterMisses ) / float( end - begin );
+
+			cache.Flush();
+			clusters.push_back( static_cast<std::uint32_t>( begin ) );
+			std::size_t runningMisses = 0, runningTriangles = 0;
+			for ( std::size_t t = begin; t < end; ++t )
+			{
+				runningMisses += cache.TriangleMisses( &indices[ t * 3 ] );
+				runningTriangles++;
+				if ( t + 1 < end && float( runningMisses ) <= clusterThreshold * float( runningTriangles ) )
+				{
+					clusters.push_back( static_cast<std::uint32_t>( t + 1 ) );
+					cache.Flush();
+					runningMisses = runningTriangles = 0;
+				}
+			}
+		}
+	}
+	if ( clusters.size() < 2 ) return;
+
+	glm::vec3 meshCenter( 0.0f );
+	for ( const Vertex& v : vertices ) meshCenter += v.position;
+	meshCenter /= float( vertices.size() );
+
+	std::vector<float> sortKey( clusters.size() );
+	for ( std::size_t c = 0; c < clusters.size(); ++c )
+	{
+		const std::size_t end = c + 1 < clusters.size() ? clusters[ c + 1 ] : triangleCount;
+
+		glm::vec3 center( 0.0f ), normal( 0.0f );
+		float area = 0.0f;
+		for ( std::size_t t = clusters[ c ]; t < end; ++t )
+		{
+			const glm::vec3& p0 = vertices[ indices[ t * 3 + 0 ] ].position;
+			const glm::vec3& p1 = vertices[ indices[ t * 3 + 1 ] ].position;
+			const glm::vec3& p2 = vertices[ indices[ t * 3 + 2 ] ].position;
+
+			const glm::vec3 areaNormal = glm::cross( p1 - p0, p2 - p0 ); // hossza a terület kétszerese
+			const float triangleArea = glm::length( areaNormal );
+			center += ( p0 + p1 + p2 ) * ( triangleArea / 3.0f );
+			normal += areaNormal;
+			area += triangleArea;
+		}
+
+		const float normalLength = glm::length( normal );
+		sortKey[ c ] = ( area > 0.0f && normalLength > 0.0f ) ? glm::dot( center / area - meshCenter, normal / normalLength ) : 0.0f;
+	}
+
+	std::vector<std::uint32_t> order( clusters.size() );
+	std::iota( order.begin(), order.end(), 0 );
+	std::stable_sort( order.begin(), order.end(), [ &sortKey ]( std::uint32_t a, std::uint32_t b ) { return sortKey[ a ] > sortKey[ b ]; } );
+
+	std::vector<std::uint32_t> result;
+	result.reserve( indices.size() );
+	for ( const std::uint32_t c : order )
+	{
+		const std::size_t end = c + 1 < clusters.size() ? clusters[ c + 1 ] : triangleCount;
+		result.insert( result.end(), indices.cbegin() + clusters[ c ] * 3, indices.cbegin() + end * 3 );
+	}
+	result.insert( result.end(), indices.cbegin() + triangleCount * 3, indices.cend() );
+	indices.swap( result );
+}
+
+void OptimizeVertexFetch( MeshObject<Vertex>& mesh )
+{
+	constexpr std::uint32_t UNUSED = ~std::uint32_t( 0 );
+
+	std::vector<std::uint32_t> remap( mesh.vertexArray.size(), UNUSED );
+	std::vector<Vertex> vertices;
+	vertices.reserve( mesh.vertexArray.size() );
+
+	for ( std::uint32_t& index : mesh.indexArray )
+	{
+		if ( remap[ index ] == UNUSED )
+		{
+			remap[ index ] = static_cast<std::uint32_t>( vertices.size() );
+			vertices.push_back( mesh.vertexArray[ index ] );
+		}
+		index = remap[ index ];
+	}
+
+	mesh.vertexArray.swap( vertices );
+}
+
+MeshOptimizationStats OptimizeMesh( MeshObject<Vertex>& mesh, float overdrawThreshold )
+{
+	MeshOptimizationStats stats;
+	if ( mesh.topology != MeshTopology::TriangleList ) return stats; // a sávok sorrendje maga a geometria
+
+	stats.before = AnalyzeVertexCache( mesh.indexArray.data(), mesh.indexArray.size(), mesh.vertexArray.size() );
+
+	std::vector<std::uint32_t> clusterStarts;
+	OptimizeVertexCache( mesh.indexArray, mesh.vertexArray.size(), VERTEX_CACHE_SIZE, &clusterStarts );
+	OptimizeOverdraw( mesh.indexArray, mesh.vertexArray, clusterStarts, overdrawThreshold );
+	OptimizeVertexFetch( mesh );
+
+	stats.after = AnalyzeVertexCache( mesh.indexArray.data(), mesh.indexArray.size(), mesh.vertexArray.size() );
+	return stats;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MeshObject.hpp"
+
+// Betöltés utáni, opcionális mesh optimalizálás a GPU-hoz:
+//  - háromszög sorrend a post-transform vertex cache-hez (Tipsify, Sander et al. 2007),
+//  - klaszterek sorrendje az overdraw csökkentésére (kívülről befelé),
+//  - csúcs sorrend az első használat szerint (vertex fetch lokalitás).
+// Egyik sem változtat a megjelenített geometrián, csak az index- és csúcstömb sorrendjén.
+
+// FIFO vertex cache mérete, amire optimalizálunk és amivel mérünk
+constexpr unsigned int VERTEX_CACHE_SIZE = 16;
+
+struct VertexCacheStats
+{
+	float acmr = 0.0f; // average cache miss ratio: cache hibák / háromszög (0.5 .. 3)
+	float atvr = 0.0f; // average transformed vertex ratio: cache hibák / csúcs (1 az ideális)
+};
+
+struct MeshOptimizationStats
+{
+	VertexCacheStats before;
+	VertexCacheStats after;
+};
+
+// FIFO cache szimuláció az index listán (háromszög lista)
+VertexCacheStats AnalyzeVertexCache( const std::uint32_t* indices, std::size_t indexCount, std::size_t vertexCount, unsigned int cacheSize = VERTEX_CACHE_SIZE );
+
+// Tipsify háromszög átrendezés. Ha clusterStarts != nullptr, oda kerülnek a klaszterek
+// (zsákutcából való ugrások) első háromszögeinek sorszámai, növekvő sorrendben, 0-val kezdve.
+void OptimizeVertexCache( std::vector<std::uint32_t>& indices, std::size_t vertexCount, unsigned int cacheSize = VERTEX_CACHE_SIZE,
+						  std::vector<std::uint32_t>* clusterStarts = nullptr );
+
+// Az OptimizeVertexCache klasztereit tovább bontja ott, ahol az ACMR legfeljebb threshold-szorosára romlik,
+// majd a klasztereket úgy rendezi, hogy a középponttól kifelé néző (valószínűleg takaró) részek kerüljenek előre.
+void OptimizeOverdraw( std::vector<std::uint32_t>& indices, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& clusterStarts,
+					   float threshold = 1.05f, unsigned int cacheSize = VERTEX_CACHE_SIZE );
+
+// A csúcsokat az index lista szerinti első használat sorrendjébe rakja, a nem használtakat elhagyja.
+void OptimizeVertexFetch( MeshObject<Vertex>& mesh );
+
+// A fenti három egymás után; csak háromszög listán (MeshTopology::TriangleList), sávokat nem módosít
+MeshOptimizationStats OptimizeMesh( MeshObject<Vertex>& mesh, float overdrawThreshold = 1.05f );
@@ -0,0 +1,186 @@
+#include "MeshPacking.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// A GL normalizált előjeles egész konverziója (GL 4.2+): max( q / (2^(b-1) - 1), -1 )
+static float SnormToFloat( int value, int maxValue ) noexcept
+{
+	return std::max( float( value ) / float( maxValue ), -1.0f );
+}
+
+static int FloatToSnorm( float value, int maxValue ) noexcept
+{
+	return static_cast<int>( std::lround( std::clamp( value, -1.0f, 1.0f ) * float( maxValue ) ) );
+}
+
+// Kerekítés a legközelebbi, egyenlőségnél páros half értékre; a túl nagy értékekből végtelen lesz.
+std::uint16_t FloatToHalf( float value ) noexcept
+{
+	constexpr std::uint32_t FLOAT_INFINITY = 255u << 23;
+	constexpr std::uint32_t HALF_OVERFLOW = ( 127u + 16u ) << 23;     // 2^16: innen már végtelen
+	constexpr std::uint32_t HALF_NORMAL_MIN = ( 127u - 14u ) << 23;   // 2^-14: ez alatt denormalizált
+	constexpr std::uint32_t DENORM_MAGIC = ( ( 127u - 15u ) + ( 23u - 10u ) + 1u ) << 23;
+
+	std::uint32_t bits;
+	std::memcpy( &bits, &value, sizeof( bits ) );
+	const std::uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	std::uint32_t half;
+	if ( bits >= HALF_OVERFLOW )
+	{
+		half = bits > FLOAT_INFINITY ? 0x7e00u : 0x7c00u; // NaN : végtelen
+	}
+	else if ( bits < HALF_NORMAL_MIN )
+	{
+		// a lebegőpontos összeadás kerekít a denormalizált half mantissza pontosságára
+		float magic, sum;
+		std::memcpy( &magic, &DENORM_MAGIC, sizeof( magic ) );
+		std::memcpy( &sum, &bits, sizeof( sum ) );
+		sum += magic;
+		std::memcpy( &half, &sum, sizeof( half ) );
+		half -= DENORM_MAGIC;
+	}
+	else
+	{
+		const std::uint32_t mantissaOdd = ( bits >> 13 ) & 1u;
+		bits += ( ( 15u - 127u ) << 23 ) + 0xfffu; // exponens átírása és kerekítés
+		bits += mantissaOdd;
+		half = bits >> 13;
+	}
+
+	return static_cast<std::uint16_t>( half | ( sign >> 16 ) );
+}
+
+float HalfToFloat( std::uint16_t value ) noexcept
+{
+	const std::uint32_t sign = std::uint32_t( value & 0x8000u ) << 16;
+	const std::uint32_t exponent = ( value >> 10 ) & 0x1fu;
+	const std::uint32_t mantissa = value & 0x3ffu;
+
+	float result;
+	if ( exponent == 0 )
+	{
+		result = std::ldexp( float( mantissa ), -24 ); // denormalizált (vagy 0)
+	}
+	else if ( exponent == 31 )
+	{
+		result = mantissa == 0 ? INFINITY : NAN;
+	}
+	else
+	{
+		const std::uint32_t bits = ( ( exponent + 127u - 15u ) << 23 ) | ( mantissa << 13 );
+		std::memcpy( &result, &bits, sizeof( result ) );
+	}
+
+	return sign ? -result : result;
+}
+
+glm::vec3 DecodeOctahedral( const std::int8_t encoded[ 2 ] ) noexcept
+{
+	glm::vec3 normal( SnormToFloat( encoded[ 0 ], 127 ), SnormToFloat( encoded[ 1 ], 127 ), 0.0f );
+	normal.z = 1.0f - std::abs( normal.x ) - std::abs( normal.y );
+
+	// az alsó félgömb a négyzet sarkaiba van kihajtva
+	const float t = std::max( -normal.z, 0.0f );
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+
+	return glm::normalize( normal );
+}
+
+// A négy szomszédos rácspont közül azt választjuk, amelyik visszafejtve a legközelebb van
+// (Cigolle et al., "A Survey of Efficient Representations for Independent Unit Vectors", 2014).
+void EncodeOctahedral( const glm::vec3& normal, std::int8_t encoded[ 2 ] ) noexcept
+{
+	const float l1Norm = std::abs( normal.x ) + std::abs( normal.y ) + std::abs( normal.z );
+	if ( l1Norm == 0.0f )
+	{
+		encoded[ 0 ] = encoded[ 1 ] = 0;
+		return;
+	}
+
+	glm::vec2 p = glm::vec2( normal.x, normal.y ) / l1Norm;
+	if ( normal.z < 0.0f )
+	{
+		p = glm::vec2( ( 1.0f - std::abs( p.y ) ) * ( p.x >= 0.0f ? 1.0f : -1.0f ),
+					   ( 1.0f - std::abs( p.x ) ) * ( p.y >= 0.0f ? 1.0f : -1.0f ) );
+	}
+
+	const glm::vec3 unitNormal = normal / glm::length( normal );
+	const glm::vec2 scaled = p * 127.0f;
+	float bestDot = -2.0f;
+	for ( int i = 0; i < 4; ++i )
+	{
+		std::int8_t candidate[ 2 ];
+		candidate[ 0 ] = static_cast<std::int8_t>( std::clamp( ( i & 1 ) ? std::ceil( scaled.x ) : std::floor( scaled.x ), -127.0f, 127.0f ) );
+		candidate[ 1 ] = static_cast<std::int8_t>( std::clamp( ( i & 2 ) ? std::ceil( scaled.y ) : std::floor( scaled.y ), -127.0f, 127.0f ) );
+
+		const float d = glm::dot( DecodeOctahedral( candidate ), unitNormal );
+		if ( d > bestDot )
+		{
+			bestDot = d;
+			encoded[ 0 ] = candidate[ 0 ];
+			encoded[ 1 ] = candidate[ 1 ];
+		}
+	}
+}
+
+Vertex UnpackVertex( const VertexPacked& packed, const PositionQuantization& quantization ) noexcept
+{
+	Vertex v;
+	v.position = glm::vec3( SnormToFloat( packed.position[ 0 ], 32767 ),
+							SnormToFloat( packed.position[ 1 ], 32767 ),
+							SnormToFloat( packed.position[ 2 ], 32767 ) ) * quantization.scale + quantization.offset;
+	v.normal = DecodeOctahedral( packed.normal );
+	v.texcoord = glm::vec2( HalfToFloat( packed.texcoord[ 0 ] ), HalfToFloat( packed.texcoord[ 1 ] ) );
+	return v;
+}
+
+PackedMesh PackMesh( const MeshView<Vertex>& mesh )
+{
+	PackedMesh result;
+	PackMesh( mesh, result );
+	return result;
+}
+
+void PackMesh( const MeshView<Vertex>& mesh, PackedMesh& result )
+{
+	result.mesh.indexArray.assign( mesh.indices, mesh.indices + mesh.indexCount );
+	result.mesh.topology = mesh.topology;
+	result.mesh.vertexArray.resize( mesh.vertexCount );
+	result.quantization = PositionQuantization();
+	if ( mesh.vertexCount == 0 ) return;
+
+	// befoglaló doboz -> [-1, 1]^3
+	glm::vec3 boxMin = mesh.vertices[ 0 ].position, boxMax = mesh.vertices[ 0 ].position;
+	for ( std::size_t i = 1; i < mesh.vertexCount; ++i )
+	{
+		boxMin = glm::min( boxMin, mesh.vertices[ i ].position );
+		boxMax = glm::max( boxMax, mesh.vertices[ i ].position );
+	}
+
+	PositionQuantization& quantization = result.quantization;
+	quantization.offset = ( boxMin + boxMax ) * 0.5f;
+	quantization.scale = ( boxMax - boxMin ) * 0.5f;
+	for ( int c = 0; c < 3; ++c )
+	{
+		if ( quantization.scale[ c ] <= 0.0f ) quantization.scale[ c ] = 1.0f; // lapos mesh
+	}
+
+	for ( std::size_t i = 0; i < mesh.vertexCount; ++i )
+	{
+		const Vertex& v = mesh.vertices[ i ];
+		VertexPacked& packed = result.mesh.vertexArray[ i ];
+
+		const glm::vec3 normalized = ( v.position - quantization.offset ) / quantization.scale;
+		for ( int c = 0; c < 3; ++c ) packed.position[ c ] = static_cast<std::int16_t>( FloatToSnorm( normalized[ c ], 32767 ) );
+
+		EncodeOctahedral( v.normal, packed.normal );
+
+		packed.texcoord[ 0 ] = FloatToHalf( v.texcoord.x );
+		packed.texcoord[ 1 ] = FloatToHalf( v.texcoord.y );
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "MeshObject.hpp"
+
+// Vertex -> VertexPacked átalakítás (a feltöltés előtti utolsó lépés a mesh pipeline-ban).
+// Az indexek és a csúcsok sorrendje nem változik.
+struct PackedMesh
+{
+	MeshObject<VertexPacked> mesh;
+	PositionQuantization     quantization; // a shaderben kapott [-1, 1]-es pozíciók visszaalakítása
+};
+
+PackedMesh PackMesh( const MeshView<Vertex>& mesh );
+void       PackMesh( const MeshView<Vertex>& mesh, PackedMesh& result ); // result tömbjeinek kapacitását újrahasznosítva
+
+// a VertexPacked mezőinek kódolása és visszafejtése (a visszafejtés a shader megfelelője)
+std::uint16_t FloatToHalf( float value ) noexcept;
+float         HalfToFloat( std::uint16_t value ) noexcept;
+void          EncodeOctahedral( const glm::vec3& normal, std::int8_t encoded[ 2 ] ) noexcept;
+glm::vec3     DecodeOctahedral( const std::int8_t encoded[ 2 ] ) noexcept;
+Vertex        UnpackVertex( const VertexPacked& packed, const PositionQuantization& quantization ) noexcept;
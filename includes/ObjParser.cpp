@@ -1,15 +1,180 @@
 #include "ObjParser.h"
+#include "MappedFile.hpp"
+#include "MeshOptimizer.hpp"
+#include "ThreadPool.hpp"
 #include <array>
 #include <list>
 #include <string>
 #include <charconv>
+#include <cstring>
 #include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cmath>
+#include <optional>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define OBJPARSER_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include <glm/gtx/norm.hpp>
 #include <glm/gtc/constants.hpp>
 
 using namespace std;
 
+//
+// Character classification, 64 bytes at a time
+//
+// The tokenizer keeps the whitespace and newline bitmaps of the 64 bytes around its position,
+// so finding the next token boundary is a count trailing zeros instead of a per byte test.
+// Whitespace is what std::isspace accepts in the "C" locale: ' ', '\t', '\n', '\v', '\f', '\r'.
+//
+
+static constexpr std::size_t CLASSIFY_BLOCK_SIZE = 64;
+
+struct CharMasks
+{
+	std::uint64_t space = 0;   // bit i: ptr[ i ] is whitespace
+	std::uint64_t newline = 0; // bit i: ptr[ i ] == '\n'
+};
+
+static inline bool IsSpaceChar( char c ) noexcept
+{
+	return c == ' ' || static_cast<unsigned char>( c - '\t' ) <= '\r' - '\t';
+}
+
+static inline unsigned int CountTrailingZeros( std::uint64_t mask ) noexcept
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64( &index, mask );
+	return static_cast<unsigned int>( index );
+#else
+	return static_cast<unsigned int>( __builtin_ctzll( mask ) );
+#endif
+}
+
+// Only the first length (<= 64) bytes are read; the masks are 0 above them.
+static CharMasks ClassifyChars( const char* ptr, std::size_t length ) noexcept
+{
+	CharMasks masks;
+
+#if defined(__AVX2__)
+	if ( length == CLASSIFY_BLOCK_SIZE )
+	{
+		const __m256i spaceChar = _mm256_set1_epi8( ' ' );
+		const __m256i newlineChar = _mm256_set1_epi8( '\n' );
+		const __m256i beforeTab = _mm256_set1_epi8( '\t' - 1 );
+		const __m256i afterCR = _mm256_set1_epi8( '\r' + 1 );
+		for ( std::size_t i = 0; i < CLASSIFY_BLOCK_SIZE; i += 32 )
+		{
+			const __m256i chars = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( ptr + i ) );
+			// '\t' <= c <= '\r' as signed bytes (the bytes >= 0x80 are negative, so not whitespace)
+			const __m256i control = _mm256_and_si256( _mm256_cmpgt_epi8( chars, beforeTab ), _mm256_cmpgt_epi8( afterCR, chars ) );
+			const __m256i space = _mm256_or_si256( _mm256_cmpeq_epi8( chars, spaceChar ), control );
+			masks.space |= std::uint64_t( static_cast<std::uint32_t>( _mm256_movemask_epi8( space ) ) ) << i;
+			masks.newline |= std::uint64_t( static_cast<std::uint32_t>( _mm256_movemask_epi8( _mm256_cmpeq_epi8( chars, newlineChar ) ) ) ) << i;
+		}
+		return masks;
+	}
+#elif defined(OBJPARSER_SSE2)
+	if ( length == CLASSIFY_BLOCK_SIZE )
+	{
+		const __m128i spaceChar = _mm_set1_epi8( ' ' );
+		const __m128i newlineChar = _mm_set1_epi8( '\n' );
+		const __m128i beforeTab = _mm_set1_epi8( '\t' - 1 );
+		const __m128i afterCR = _mm_set1_epi8( '\r' + 1 );
+		for ( std::size_t i = 0; i < CLASSIFY_BLOCK_SIZE; i += 16 )
+		{
+			const __m128i chars = _mm_loadu_si128( reinterpret_cast<const __m128i*>( ptr + i ) );
+			// '\t' <= c <= '\r' as signed bytes (the bytes >= 0x80 are negative, so not whitespace)
+			const __m128i control = _mm_and_si128( _mm_cmpgt_epi8( chars, beforeTab ), _mm_cmplt_epi8( chars, afterCR ) );
+			const __m128i space = _mm_or_si128( _mm_cmpeq_epi8( chars, spaceChar ), control );
+			masks.space |= std::uint64_t( static_cast<std::uint32_t>( _mm_movemask_epi8( space ) ) ) << i;
+			masks.newline |= std::uint64_t( static_cast<std::uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8( chars, newlineChar ) ) ) ) << i;
+		}
+		return masks;
+	}
+#endif
+
+	for ( std::size_t i = 0; i < length; ++i )
+	{
+		masks.space |= std::uint64_t( IsSpaceChar( ptr[ i ] ) ) << i;
+		masks.newline |= std::uint64_t( ptr[ i ] == '\n' ) << i;
+	}
+	return masks;
+}
+
+//
+// Number parsing
+//
+// Both functions give the same result as std::from_chars (and leave value unchanged where it
+// would), but handle the common short forms without the general algorithm.
+//
+
+// Unsigned decimal integer, e.g. a face index
+static inline const char* ParseIndex( const char* first, const char* last, std::uint32_t& value ) noexcept
+{
+	std::uint32_t result = 0;
+	const char* ptr = first;
+	for ( ; ptr < last && static_cast<unsigned char>( *ptr - '0' ) <= 9; ++ptr )
+	{
+		if ( ptr - first == 9 ) return std::from_chars( first, last, value ).ptr; // might overflow
+		result = result * 10 + static_cast<std::uint32_t>( *ptr - '0' );
+	}
+	if ( ptr != first ) value = result;
+	return ptr;
+}
+
+// [-]<digits>[.<digits>] with at most 2^24 as the digits and at most 10 fractional digits:
+// both the mantissa and the power of 10 are exact floats, so one division is correctly rounded
+// (Clinger's fast path), just like std::from_chars. Anything else goes to std::from_chars.
+static inline void ParseFloat( const char* first, const char* last, float& value ) noexcept
+{
+	static constexpr float POW10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+	constexpr std::uint32_t MAX_EXACT_MANTISSA = 1u << 24;
+
+	const char* ptr = first;
+	const bool negative = ( ptr < last && *ptr == '-' );
+	if ( negative ) ++ptr;
+
+	std::uint64_t mantissa = 0;
+	const char* digitsBegin = ptr;
+	for ( ; ptr < last && static_cast<unsigned char>( *ptr - '0' ) <= 9 && ptr - digitsBegin < 10; ++ptr )
+	{
+		mantissa = mantissa * 10 + static_cast<unsigned int>( *ptr - '0' );
+	}
+	std::size_t digitCount = ptr - digitsBegin;
+
+	std::size_t fractionCount = 0;
+	if ( ptr < last && *ptr == '.' )
+	{
+		const char* fractionBegin = ++ptr;
+		for ( ; ptr < last && static_cast<unsigned char>( *ptr - '0' ) <= 9 && ptr - fractionBegin < 11; ++ptr )
+		{
+			mantissa = mantissa * 10 + static_cast<unsigned int>( *ptr - '0' );
+		}
+		fractionCount = ptr - fractionBegin;
+		digitCount += fractionCount;
+	}
+
+	const bool endsHere = ( ptr == last || ( static_cast<unsigned char>( *ptr - '0' ) > 9 && *ptr != 'e' && *ptr != 'E' && *ptr != '.' ) );
+	if ( digitCount == 0 || digitCount > 18 || !endsHere || fractionCount >= std::size( POW10 ) || mantissa > MAX_EXACT_MANTISSA )
+	{
+		std::from_chars( first, last, value );
+		return;
+	}
+
+	const float result = static_cast<float>( mantissa ) / POW10[ fractionCount ];
+	value = negative ? -result : result;
+}
+
 class InMemoryTokenizer
 {
 public:
@@ -17,10 +182,19 @@ public:
 	void SetData( const char* ptr, size_t Length ) noexcept;
 	std::string_view NextToken( bool onlySameLine = false ) noexcept;
 	void ToNextLine() noexcept;
+	char PeekChar() const noexcept;
 	operator bool() const noexcept;
 private:
+	void ClassifyBlockAt( const char* ptr ) noexcept;
+
 	const char* currentPtr = nullptr;
 	const char* endPtr = nullptr;
+
+	// character classes of [blockPtr, blockPtr + blockLength), see ClassifyChars()
+	const char*   blockPtr = nullptr;
+	std::size_t   blockLength = 0;
+	std::uint64_t blockValid = 0; // bits of the bytes inside the block
+	CharMasks     blockMasks;
 };
 
 void InMemoryTokenizer::SetData( const char* ptr, size_t Length ) noexcept
@@ -29,36 +203,76 @@ void InMemoryTokenizer::SetData( const char* ptr, size_t Length ) noexcept
 	this->endPtr = ptr + Length;
 }
 
+void InMemoryTokenizer::ClassifyBlockAt( const char* ptr ) noexcept
+{
+	blockPtr = ptr;
+	blockLength = std::min<std::size_t>( CLASSIFY_BLOCK_SIZE, endPtr - ptr );
+	blockValid = blockLength == CLASSIFY_BLOCK_SIZE ? ~std::uint64_t( 0 ) : ( std::uint64_t( 1 ) << blockLength ) - 1;
+	blockMasks = ClassifyChars( ptr, blockLength );
+}
+
 std::string_view InMemoryTokenizer::NextToken( bool onlySameLine ) noexcept
 {
-	for ( ;currentPtr < endPtr 
-			&& std::isspace(static_cast<unsigned char>(*currentPtr) ); ++currentPtr )
+	// skip the whitespace (with onlySameLine stop at the end of the line)
+	while ( currentPtr < endPtr )
 	{
-		if ( onlySameLine && *currentPtr == '\n' )
+		if ( currentPtr < blockPtr || currentPtr >= blockPtr + blockLength ) ClassifyBlockAt( currentPtr );
+
+		const std::uint64_t fromCurrent = blockValid & ( ~std::uint64_t( 0 ) << ( currentPtr - blockPtr ) );
+		const std::uint64_t nonSpace = ~blockMasks.space & fromCurrent;
+		if ( onlySameLine )
 		{
-			return std::string_view();
+			const std::uint64_t beforeToken = nonSpace ? ( nonSpace & ( ~nonSpace + 1 ) ) - 1 : ~std::uint64_t( 0 );
+			const std::uint64_t newlines = blockMasks.newline & fromCurrent & beforeToken;
+			if ( newlines )
+			{
+				currentPtr = blockPtr + CountTrailingZeros( newlines );
+				return std::string_view();
+			}
 		}
+
+		if ( nonSpace )
+		{
+			currentPtr = blockPtr + CountTrailingZeros( nonSpace );
+			break;
+		}
+		currentPtr = blockPtr + blockLength;
 	}
+
 	const char* tPtr = currentPtr;
-	std::size_t tLength = 0;
 
-	while ( currentPtr < endPtr 
-			&& !std::isspace(static_cast<unsigned char>(*currentPtr) ) )
+	while ( currentPtr < endPtr )
 	{
-		currentPtr++;
-		tLength++;
+		if ( currentPtr >= blockPtr + blockLength ) ClassifyBlockAt( currentPtr );
+
+		const std::uint64_t space = blockMasks.space & blockValid & ( ~std::uint64_t( 0 ) << ( currentPtr - blockPtr ) );
+		if ( space )
+		{
+			currentPtr = blockPtr + CountTrailingZeros( space );
+			break;
+		}
+		currentPtr = blockPtr + blockLength;
 	}
 
-	return std::string_view( tPtr, tLength );
+	return std::string_view( tPtr, currentPtr - tPtr );
 }
 
 void InMemoryTokenizer::ToNextLine() noexcept
 {
-	while ( currentPtr < endPtr && *currentPtr != '\n' )
-		currentPtr++;
+	if ( currentPtr < endPtr )
+	{
+		const void* lineEnd = std::memchr( currentPtr, '\n', endPtr - currentPtr );
+		currentPtr = lineEnd ? static_cast<const char*>( lineEnd ) : endPtr;
+	}
 	currentPtr++;
 }
 
+// The character after the last token, or '\0' at the end of the data
+char InMemoryTokenizer::PeekChar() const noexcept
+{
+	return currentPtr < endPtr ? *currentPtr : '\0';
+}
+
 InMemoryTokenizer::operator bool() const noexcept
 {
 	return currentPtr < endPtr;
@@ -71,9 +285,302 @@ constexpr unsigned short From2Char( const char ch1, const char ch2)
 	return sh;
 }
 
-static std::vector<unsigned int> triangulatePolygon( const std::vector<glm::vec2>& );
+static MappedFile OpenObjFile( const std::filesystem::path& fileName )
+{
+	MappedFile objFile;
+
+	if ( !objFile.Open( fileName ) ) throw(ObjParser::EXC_FILENOTFOUND);
+
+	return objFile;
+}
+
+// v <x> <y> <z> [<w>]
+static glm::vec3 ReadPosition( InMemoryTokenizer& tokenizer ) noexcept
+{
+	glm::vec3 position;
+
+	std::string_view coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), position.x );
+	coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), position.y );
+	coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), position.z );
+	coordT = tokenizer.NextToken(true);
+
+	if ( !coordT.empty() )
+	{
+		float w;
+		ParseFloat( coordT.data(), coordT.data() + coordT.size(), w );
+		position.x /= w;
+		position.y /= w;
+		position.z /= w;
+	}
+
+	return position;
+}
+
+// vn <nx> <ny> <nz>
+static glm::vec3 ReadNormal( InMemoryTokenizer& tokenizer ) noexcept
+{
+	glm::vec3 normal;
+
+	std::string_view coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), normal.x );
+	coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), normal.y );
+	coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), normal.z );
+
+	return normal;
+}
+
+// vt <s> <t>
+static glm::vec2 ReadTexcoord( InMemoryTokenizer& tokenizer ) noexcept
+{
+	glm::vec2 texcoord;
+
+	std::string_view coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), texcoord.x );
+	coordT = tokenizer.NextToken();
+	ParseFloat( coordT.data(), coordT.data() + coordT.size(), texcoord.y );
+
+	return texcoord;
+}
+
+static glm::vec3 TriangleNormal( const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2 )
+{
+	return glm::normalize( glm::cross( p1 - p0, p2 - p0 ) );
+}
+
+// f (<pi>[/<ti>][/<ni>])3+
+// Returns true, if any of the face vertices has no normal index.
+bool ObjParser::readFaceVertices( InMemoryTokenizer& tokenizer, std::vector<IndexedVert>& face_vertIds )
+{
+	bool needsNormalComputation = false;
+
+	std::string_view faceVertT = tokenizer.NextToken( true );
+	while ( !faceVertT.empty() )
+	{
+		face_vertIds.emplace_back( IndexedVert{} );
+		IndexedVert& idxVert = face_vertIds.back();
+
+		const char* const tokenEnd = faceVertT.data() + faceVertT.size();
+
+		const char* posEnd = ParseIndex( faceVertT.data(), tokenEnd, idxVert.v );
+		if ( posEnd < tokenEnd && *posEnd != '/' ) posEnd = std::find( posEnd, tokenEnd, '/' );
+		idxVert.v--;
+
+		bool hasNormal = false;
+		if ( posEnd < tokenEnd ) // '/'
+		{
+			const char* texEnd = ParseIndex( posEnd + 1, tokenEnd, idxVert.vt );
+			if ( texEnd < tokenEnd && *texEnd != '/' ) texEnd = std::find( texEnd, tokenEnd, '/' );
+
+			if ( tokenEnd - texEnd > 1 ) // '/' and a normal index
+			{
+				ParseIndex( texEnd + 1, tokenEnd, idxVert.vn );
+				idxVert.vn--;
+				hasNormal = true;
+			}
+		}
+		if ( idxVert.vt ) idxVert.vt--;
+
+		if ( !hasNormal ) needsNormalComputation = true;
+		
+		faceVertT = tokenizer.NextToken( true );
+	}
+
+	return needsNormalComputation;
+}
+
+// Splits a face with more than 3 vertices into a triangle list (in place).
+void ObjParser::triangulateFace( std::vector<IndexedVert>& face_vertIds, const std::vector<glm::vec3>& positions )
+{
+	if ( 3 < face_vertIds.size() )
+	{
+		std::vector<IndexedVert> face_vertIdsFace2Tris;
+		if ( 4 == face_vertIds.size() )
+		{
+			glm::vec3 v10 = positions[ face_vertIds[ 0 ].v ] - positions[ face_vertIds[ 1 ].v ];
+			glm::vec3 v12 = positions[ face_vertIds[ 2 ].v ] - positions[ face_vertIds[ 1 ].v ];
+
+			glm::vec3 v32 = positions[ face_vertIds[ 2 ].v ] - positions[ face_vertIds[ 3 ].v ];
+			glm::vec3 v30 = positions[ face_vertIds[ 0 ].v ] - positions[ face_vertIds[ 3 ].v ];
+
+			float angle_012 = ::acosf( glm::dot(v10,v12) / sqrtf( glm::dot(v10,v10) * glm::dot(v12,v12) ) );
+			float angle_230 = ::acosf( glm::dot(v32,v30) / sqrtf( glm::dot(v32,v32) * glm::dot(v30,v30) ) );
+			
+			if ( ( angle_012 + angle_230 ) <= glm::pi<float>() )
+			{
+				face_vertIdsFace2Tris =
+				{ face_vertIds[ 0 ], face_vertIds[ 1 ], face_vertIds[ 2 ],
+				  face_vertIds[ 0 ], face_vertIds[ 2 ], face_vertIds[ 3 ] };
+			}
+			else
+			{
+				face_vertIdsFace2Tris =
+				{ face_vertIds[ 0 ], face_vertIds[ 1 ], face_vertIds[ 3 ],
+				  face_vertIds[ 1 ], face_vertIds[ 2 ], face_vertIds[ 3 ] };
+			}
+		}
+		else 
+		{
+			// Calculate the best fitting plane
+			glm::vec3 MidPoint( 0.0 );
+			for ( const auto& vertex : face_vertIds )
+			{
+				MidPoint += positions[ vertex.v ];
+			}
+			MidPoint /= float( face_vertIds.size() );
+
+			std::vector<glm::vec3> centeredPoints( face_vertIds.size() );
+
+			std::transform( face_vertIds.cbegin(), face_vertIds.cend(), centeredPoints.begin(),
+							[&positions,MidPoint]( const IndexedVert& faceV )->glm::vec3
+							{ return positions[ faceV.v ] - MidPoint;}
+							);
+
+			float cov_xx = 0.0f, cov_xy = 0.0f;
+			float cov_yy = 0.0f, cov_yz = 0.0f;
+			float cov_xz = 0.0f, cov_zz = 0.0f;
+
+			for ( const glm::vec3& centeredP : centeredPoints )
+			{
+				cov_xx += centeredP.x * centeredP.x;
+				cov_xy += centeredP.x * centeredP.y;
+				
+				cov_yy += centeredP.y * centeredP.y;
+				cov_yz += centeredP.y * centeredP.z;
+
+				cov_xz += centeredP.x * centeredP.z;
+				cov_zz += centeredP.z * centeredP.z;
+			}
+
+			// viktor-vad: Very strange, but the pca.hpp and pca.inc disappeared from glm/gtx.
+			// Did not find any explanation for this.
+			// Instead of some header file copy-hacking, I implemented a 3x3 verion of eigen decomposition.
+			// It was not intended, but most likely it is faster than the original glm pca, since that is a general method with Housholder and QR.
+			// https://dl.acm.org/doi/epdf/10.1145/355578.366316
+			// https://en.wikipedia.org/wiki/Eigenvalue_algorithm#2%C3%972_matrices
+			glm::vec3 eigenVectors[2];
+			{
+				glm::vec3 eigenVectors_[3];
+				float p1 = cov_xy * cov_xy + cov_xz * cov_xz + cov_yz * cov_yz;
+				float trC = cov_xx + cov_yy + cov_zz;
+				float eig1 = 0.0f, eig2 = 0.0f, eig3 = 0.0f;
+
+				// normal case
+				if ( p1 > 1e-15f )
+				{
+					float q = trC / 3.0f;
+					float p2 = ( cov_xx - q ) * ( cov_xx - q ) + ( cov_yy - q ) * ( cov_yy - q ) + ( cov_zz - q ) * ( cov_zz - q ) + 2.0f * p1;
+					float p = std::sqrt( p2 / 6.0f );
+
+					float cov_xx_q = cov_xx - q;
+					float cov_yy_q = cov_yy - q;
+					float cov_zz_q = cov_zz - q;
+
+					float r = glm::clamp( ( cov_xx_q * cov_yy_q * cov_zz_q + 2.0f * cov_xy * cov_yz * cov_xz - cov_xx_q * cov_yz * cov_yz - cov_yy_q * cov_xz * cov_xz - cov_zz_q * cov_xy * cov_xy ) / ( 2.0f * p * p * p ),
+										  -1.0f, 1.0f );
+
+					float phi = ::acosf( r ) / 3.0f;
+
+					eig1 = q + 2.0f * p * std::cos( phi );
+					eig2 = q + 2.0f * p * std::cos( phi + ( 2.0f * glm::pi<float>() / 3.0f ) );
+					eig3 = trC - eig1 - eig2;
+				}
+				else // covariance matrix is numericaly diagonal. We assume eigen values are the diagonal values.
+				{
+					eig1 = std::max( { cov_xx, cov_yy, cov_zz } );
+					eig3 = std::min( { cov_xx, cov_yy, cov_zz } );
+					eig2 = trC - eig1 - eig2;
+				}
+
+				eigenVectors_[ 0 ] = glm::vec3( cov_xy * cov_xy + cov_xz * cov_xz + ( cov_xx - eig2 ) * ( cov_xx - eig3 ),
+											   cov_xy * ( ( cov_xx - eig3 ) + ( cov_yy - eig2 ) ) + cov_xz * cov_yz,
+											   cov_xz * ( ( cov_xx - eig3 ) + ( cov_zz - eig2 ) ) + cov_xy * cov_yz );
+
+				eigenVectors_[ 1 ] = glm::vec3( cov_xy * ( ( cov_xx - eig1 ) + ( cov_yy - eig3 ) ) + cov_xz * cov_yz,
+											   cov_yz * cov_yz + cov_xy * cov_xy + ( cov_yy - eig1 ) * ( cov_yy - eig3 ),
+											   cov_yz * ( ( cov_yy - eig3 ) + ( cov_zz - eig1 ) ) + cov_xy * cov_xz );
+
+				eigenVectors_[ 2 ] = glm::vec3( cov_xz * ( ( cov_xx - eig1 ) + ( cov_zz - eig2 ) ) + cov_xy * cov_yz,
+											   cov_yz * ( ( cov_yy - eig1 ) + ( cov_zz - eig2 ) ) + cov_xy * cov_xz,
+											   cov_yz * cov_yz + cov_xz * cov_xz + ( cov_zz - eig1 ) * ( cov_zz - eig2 ) );
+				
+				// Simplification of original method.
+				// We only need the first 2 eigen vectors for 2D projection.
+				// Therefor we are not intereted, which is bigger, but in leaving the smallest out.
+				float minEig = std::min( { eig1, eig2, eig3 } );
+
+				if ( eig3 == minEig )
+				{
+					eigenVectors[ 0 ] = glm::normalize( eigenVectors_[ 0 ] );
+					eigenVectors[ 1 ] = glm::normalize( eigenVectors_[ 1 ] );
+				}
+				else if ( eig2 == minEig )
+				{
+                                eigenVectors[ 0 ] = glm::normalize( eigenVectors_[ 0 ] );
+                                eigenVectors[ 1 ] = glm::normalize( eigenVectors_[ 2 ] );
+                            }
+				else //if ( eig1 == minEig ) most unlikly case
+				{
+                                eigenVectors[ 0 ] = glm::normalize( eigenVectors_[ 1 ] );
+                                eigenVectors[ 1 ] = glm::normalize( eigenVectors_[ 2 ] );
+                            }
+			}
+
+			std::vector<glm::vec2> facePointsProjected( face_vertIds.size() );
+			
+
+			std::transform(centeredPoints.cbegin(),centeredPoints.cend(),facePointsProjected.begin(),
+							[ &eigenVectors ]( const glm::vec3& cp )->glm::vec2
+							{
+								return glm::vec2(
+									glm::dot( cp, eigenVectors[0] ),
+									glm::dot( cp, eigenVectors[1] )
+								);
+							} );
+
+			// checking the orientation. CCW should be kept
+			float sum = 0.0;
+			for ( int i = 0; i < facePointsProjected.size() - 1; ++i )
+			{
+				sum += ( facePointsProjected[ i + 1 ].x - facePointsProjected[ i ].x ) *
+					( facePointsProjected[ i + 1 ].y + facePointsProjected[ i ].y );
+			}
+			sum += ( facePointsProjected.front().x - facePointsProjected.back().x ) *
+				( facePointsProjected.front().y + facePointsProjected.back().y );
+
+			if ( sum > 0.0f )
+			{
+				for ( int i = 0; i < facePointsProjected.size(); ++i )
+					facePointsProjected[ i ].y *= -1.0f;
+			}
+
+			std::vector<unsigned int> triIndices = triangulatePolygon( facePointsProjected );
+			
+			face_vertIdsFace2Tris.resize( triIndices.size() );
+			std::transform( triIndices.cbegin(), triIndices.cend(), face_vertIdsFace2Tris.begin(),
+							[ &face_vertIds ]( const unsigned int fTriId )->IndexedVert
+							{
+								return face_vertIds[ fTriId ];
+							} );
+
+		}
+		face_vertIds = std::move( face_vertIdsFace2Tris );
+	}
+}
 
 ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
+{
+	// the file is parsed directly from the page cache, without copying it into a buffer
+	MappedFile objFile = OpenObjFile( fileName );
+
+	return parseData( objFile.Data(), objFile.Size() );
+}
+
+ObjParser::Mesh ObjParser::parseData( const char* data, std::size_t size )
 {
 	Mesh resultMesh;
 
@@ -84,24 +591,12 @@ ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
 	std::vector<IndexedVert> face_vertIds;
 	face_vertIds.reserve( 4 );
 	bool needsNormalComputation = false;
-	std::unordered_map<IndexedVert, unsigned int, IndexedVertHash> vertexIndices;
-
-	std::error_code ec;
-	std::size_t fileSize = std::filesystem::file_size( fileName, ec );
-
-	if ( ec ) throw(EXC_FILENOTFOUND);
-
-	std::vector<char> objRawData( fileSize );
-
-	std::ifstream objFileStrm( fileName, std::ios::binary );
-
-	if ( !objFileStrm ) throw(EXC_FILENOTFOUND);
-
-	objFileStrm.read( objRawData.data(), fileSize );
+	// pre-sized for ~1 unique vertex per 128 bytes of OBJ text (it still grows if needed)
+	VertexIndexMap vertexIndices( size / 128 );
 
 	InMemoryTokenizer tokenizer;
 
-	tokenizer.SetData( objRawData.data(), fileSize );
+	tokenizer.SetData( data, size );
 
 	unsigned int nIndexedVerts = 0;
 
@@ -109,13 +604,17 @@ ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
 	{
 		std::string_view token = tokenizer.NextToken();
 
+		if ( token.empty() ) break; // only whitespace left
+
 		if ( token[ 0 ] == '#' )
 		{
 			tokenizer.ToNextLine();
 			continue;
 		}
 
-		switch ( *reinterpret_cast<const unsigned short*>( token.data() ) )
+		// the data may end right after a one character token (it is not padded), so the second
+		// character of the record type is read through the tokenizer
+		switch ( From2Char( token[ 0 ], token.size() > 1 ? token[ 1 ] : tokenizer.PeekChar() ) )
 		{
 			case From2Char('m','t'): //mtllib <.mtl file>
 			{
@@ -141,278 +640,35 @@ ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
 			case From2Char('v',' '):
 			case From2Char('v','\t'): // v <x> <y> <z> [<w>]
 			{
-				positions.emplace_back(glm::vec3());
-
-				float& x = positions.back().x;
-				float& y = positions.back().y;
-				float& z = positions.back().z;
-
-				std::string_view coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), x );
-				coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), y );
-				coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), z );
-				coordT = tokenizer.NextToken(true);
-
-				if ( !coordT.empty() )
-				{
-					float w;
-					std::from_chars( coordT.data(), coordT.data() + coordT.size(), w );
-					x /= w;
-					y /= w;
-					z /= w;
-				}
+				positions.emplace_back( ReadPosition( tokenizer ) );
 			}break;
 			case From2Char('v','n'): // vn <nx> <ny> <nz>
 			{
-				normals.emplace_back(glm::vec3());
-
-				float& x = normals.back().x;
-				float& y = normals.back().y;
-				float& z = normals.back().z;
-
-				std::string_view coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), x );
-				coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), y );
-				coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), z );
-				
+				normals.emplace_back( ReadNormal( tokenizer ) );
 			}break;
 			case From2Char('v','t'): // vt <s> <t>
 			{
-				texcoords.emplace_back(glm::vec2());
-
-				float& s = texcoords.back().x;
-				float& t = texcoords.back().y;
-
-				std::string_view coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), s );
-				coordT = tokenizer.NextToken();
-				std::from_chars( coordT.data(), coordT.data() + coordT.size(), t );
-	
+				texcoords.emplace_back( ReadTexcoord( tokenizer ) );
 			}break;
 			case From2Char('f',' '):
 			case From2Char('f','\t'): // f (<pi>[/<ti>][/<ni>])3+
 			{
 				face_vertIds.clear();
-				needsNormalComputation = false;
-
-				std::string_view faceVertT = tokenizer.NextToken( true );
-				while ( !faceVertT.empty() )
-				{
-					face_vertIds.emplace_back( IndexedVert{} );
-					IndexedVert& idxVert = face_vertIds.back();
-
-					size_t posEndOffs = faceVertT.find_first_of( '/', 0 );
-					if ( posEndOffs == std::string_view::npos ) posEndOffs = faceVertT.size();
+				needsNormalComputation = readFaceVertices( tokenizer, face_vertIds );
 
-					std::from_chars( faceVertT.data(), faceVertT.data() + posEndOffs, idxVert.v );
-					idxVert.v--;
-
-					size_t texStartOffs = posEndOffs + 1;
-					size_t texEndOffs = faceVertT.find_first_of( '/', texStartOffs );
-					if ( texEndOffs == std::string_view::npos ) texEndOffs = faceVertT.size();
-					if ( texEndOffs > texStartOffs ) std::from_chars( faceVertT.data() + texStartOffs, faceVertT.data() + texEndOffs, idxVert.vt);
-					if ( idxVert.vt ) idxVert.vt--; 
-					size_t normStartOffs = texEndOffs + 1;
-
-					if ( faceVertT.size() > normStartOffs )
-					{
-						std::from_chars( faceVertT.data() + normStartOffs, faceVertT.data() + faceVertT.size(), idxVert.vn );
-						idxVert.vn--;
-					}
-					else needsNormalComputation = true;
-					
-					faceVertT = tokenizer.NextToken( true );
-				}
-
-				if ( 3 < face_vertIds.size() )
-				{
-					std::vector<IndexedVert> face_vertIdsFace2Tris;
-					if ( 4 == face_vertIds.size() )
-					{
-						glm::vec3 v10 = positions[ face_vertIds[ 0 ].v ] - positions[ face_vertIds[ 1 ].v ];
-						glm::vec3 v12 = positions[ face_vertIds[ 2 ].v ] - positions[ face_vertIds[ 1 ].v ];
-
-						glm::vec3 v32 = positions[ face_vertIds[ 2 ].v ] - positions[ face_vertIds[ 3 ].v ];
-						glm::vec3 v30 = positions[ face_vertIds[ 0 ].v ] - positions[ face_vertIds[ 3 ].v ];
-
-						float angle_012 = ::acosf( glm::dot(v10,v12) / sqrtf( glm::dot(v10,v10) * glm::dot(v12,v12) ) );
-						float angle_230 = ::acosf( glm::dot(v32,v30) / sqrtf( glm::dot(v32,v32) * glm::dot(v30,v30) ) );
-						
-						if ( ( angle_012 + angle_230 ) <= glm::pi<float>() )
-						{
-							face_vertIdsFace2Tris =
-							{ face_vertIds[ 0 ], face_vertIds[ 1 ], face_vertIds[ 2 ],
-							  face_vertIds[ 0 ], face_vertIds[ 2 ], face_vertIds[ 3 ] };
-						}
-						else
-						{
-							face_vertIdsFace2Tris =
-							{ face_vertIds[ 0 ], face_vertIds[ 1 ], face_vertIds[ 3 ],
-							  face_vertIds[ 1 ], face_vertIds[ 2 ], face_vertIds[ 3 ] };
-						}
-					}
-					else 
-					{
-						// Calculate the best fitting plane
-						glm::vec3 MidPoint( 0.0 );
-						for ( const auto& vertex : face_vertIds )
-						{
-							MidPoint += positions[ vertex.v ];
-						}
-						MidPoint /= float( face_vertIds.size() );
-
-						std::vector<glm::vec3> centeredPoints( face_vertIds.size() );
-
-						std::transform( face_vertIds.cbegin(), face_vertIds.cend(), centeredPoints.begin(),
-										[&positions,MidPoint]( const IndexedVert& faceV )->glm::vec3
-										{ return positions[ faceV.v ] - MidPoint;}
-										);
-
-						float cov_xx = 0.0f, cov_xy = 0.0f;
-						float cov_yy = 0.0f, cov_yz = 0.0f;
-						float cov_xz = 0.0f, cov_zz = 0.0f;
-
-						for ( const glm::vec3& centeredP : centeredPoints )
-						{
-							cov_xx += centeredP.x * centeredP.x;
-							cov_xy += centeredP.x * centeredP.y;
-							
-							cov_yy += centeredP.y * centeredP.y;
-							cov_yz += centeredP.y * centeredP.z;
-
-							cov_xz += centeredP.x * centeredP.z;
-							cov_zz += centeredP.z * centeredP.z;
-						}
-
-						// viktor-vad: Very strange, but the pca.hpp and pca.inc disappeared from glm/gtx.
-						// Did not find any explanation for this.
-						// Instead of some header file copy-hacking, I implemented a 3x3 verion of eigen decomposition.
-						// It was not intended, but most likely it is faster than the original glm pca, since that is a general method with Housholder and QR.
-						// https://dl.acm.org/doi/epdf/10.1145/355578.366316
-						// https://en.wikipedia.org/wiki/Eigenvalue_algorithm#2%C3%972_matrices
-						glm::vec3 eigenVectors[2];
-						{
-							glm::vec3 eigenVectors_[3];
-							float p1 = cov_xy * cov_xy + cov_xz * cov_xz + cov_yz * cov_yz;
-							float trC = cov_xx + cov_yy + cov_zz;
-							float eig1 = 0.0f, eig2 = 0.0f, eig3 = 0.0f;
-
-							// normal case
-							if ( p1 > 1e-15f )
-							{
-								float q = trC / 3.0f;
-								float p2 = ( cov_xx - q ) * ( cov_xx - q ) + ( cov_yy - q ) * ( cov_yy - q ) + ( cov_zz - q ) * ( cov_zz - q ) + 2.0f * p1;
-								float p = std::sqrt( p2 / 6.0f );
-
-								float cov_xx_q = cov_xx - q;
-								float cov_yy_q = cov_yy - q;
-								float cov_zz_q = cov_zz - q;
-
-								float r = glm::clamp( ( cov_xx_q * cov_yy_q * cov_zz_q + 2.0f * cov_xy * cov_yz * cov_xz - cov_xx_q * cov_yz * cov_yz - cov_yy_q * cov_xz * cov_xz - cov_zz_q * cov_xy * cov_xy ) / ( 2.0f * p * p * p ),
-													  -1.0f, 1.0f );
-
-								float phi = ::acosf( r ) / 3.0f;
-
-								eig1 = q + 2.0f * p * std::cos( phi );
-								eig2 = q + 2.0f * p * std::cos( phi + ( 2.0f * glm::pi<float>() / 3.0f ) );
-								eig3 = trC - eig1 - eig2;
-							}
-							else // covariance matrix is numericaly diagonal. We assume eigen values are the diagonal values.
-							{
-								eig1 = std::max( { cov_xx, cov_yy, cov_zz } );
-								eig3 = std::min( { cov_xx, cov_yy, cov_zz } );
-								eig2 = trC - eig1 - eig2;
-							}
-
-							eigenVectors_[ 0 ] = glm::vec3( cov_xy * cov_xy + cov_xz * cov_xz + ( cov_xx - eig2 ) * ( cov_xx - eig3 ),
-														   cov_xy * ( ( cov_xx - eig3 ) + ( cov_yy - eig2 ) ) + cov_xz * cov_yz,
-														   cov_xz * ( ( cov_xx - eig3 ) + ( cov_zz - eig2 ) ) + cov_xy * cov_yz );
-
-							eigenVectors_[ 1 ] = glm::vec3( cov_xy * ( ( cov_xx - eig1 ) + ( cov_yy - eig3 ) ) + cov_xz * cov_yz,
-														   cov_yz * cov_yz + cov_xy * cov_xy + ( cov_yy - eig1 ) * ( cov_yy - eig3 ),
-														   cov_yz * ( ( cov_yy - eig3 ) + ( cov_zz - eig1 ) ) + cov_xy * cov_xz );
-
-							eigenVectors_[ 2 ] = glm::vec3( cov_xz * ( ( cov_xx - eig1 ) + ( cov_zz - eig2 ) ) + cov_xy * cov_yz,
-														   cov_yz * ( ( cov_yy - eig1 ) + ( cov_zz - eig2 ) ) + cov_xy * cov_xz,
-														   cov_yz * cov_yz + cov_xz * cov_xz + ( cov_zz - eig1 ) * ( cov_zz - eig2 ) );
-							
-							// Simplification of original method.
-							// We only need the first 2 eigen vectors for 2D projection.
-							// Therefor we are not intereted, which is bigger, but in leaving the smallest out.
-							float minEig = std::min( { eig1, eig2, eig3 } );
-
-							if ( eig3 == minEig )
-							{
-								eigenVectors[ 0 ] = glm::normalize( eigenVectors_[ 0 ] );
-								eigenVectors[ 1 ] = glm::normalize( eigenVectors_[ 1 ] );
-							}
-							else if ( eig2 == minEig )
-							{
-                                eigenVectors[ 0 ] = glm::normalize( eigenVectors_[ 0 ] );
-                                eigenVectors[ 1 ] = glm::normalize( eigenVectors_[ 2 ] );
-                            }
-							else //if ( eig1 == minEig ) most unlikly case
-							{
-                                eigenVectors[ 0 ] = glm::normalize( eigenVectors_[ 1 ] );
-                                eigenVectors[ 1 ] = glm::normalize( eigenVectors_[ 2 ] );
-                            }
-						}
-
-						std::vector<glm::vec2> facePointsProjected( face_vertIds.size() );
-						
-
-						std::transform(centeredPoints.cbegin(),centeredPoints.cend(),facePointsProjected.begin(),
-										[ &eigenVectors ]( const glm::vec3& cp )->glm::vec2
-										{
-											return glm::vec2(
-												glm::dot( cp, eigenVectors[0] ),
-												glm::dot( cp, eigenVectors[1] )
-											);
-										} );
-
-						// checking the orientation. CCW should be kept
-						float sum = 0.0;
-						for ( int i = 0; i < facePointsProjected.size() - 1; ++i )
-						{
-							sum += ( facePointsProjected[ i + 1 ].x - facePointsProjected[ i ].x ) *
-								( facePointsProjected[ i + 1 ].y + facePointsProjected[ i ].y );
-						}
-						sum += ( facePointsProjected.front().x - facePointsProjected.back().x ) *
-							( facePointsProjected.front().y + facePointsProjected.back().y );
-
-						if ( sum > 0.0f )
-						{
-							for ( int i = 0; i < facePointsProjected.size(); ++i )
-								facePointsProjected[ i ].y *= -1.0f;
-						}
-
-						std::vector<unsigned int> triIndices = triangulatePolygon( facePointsProjected );
-						
-						face_vertIdsFace2Tris.resize( triIndices.size() );
-						std::transform( triIndices.cbegin(), triIndices.cend(), face_vertIdsFace2Tris.begin(),
-										[ &face_vertIds ]( const unsigned int fTriId )->IndexedVert
-										{
-											return face_vertIds[ fTriId ];
-										} );
-
-					}
-					face_vertIds = std::move( face_vertIdsFace2Tris );
-				}
+				triangulateFace( face_vertIds, positions );
 				
 				if ( texcoords.empty() ) texcoords.emplace_back( glm::vec2( 0.0 ) );
 				
 				if ( needsNormalComputation )
 				{
-					for ( int i = 0; i < face_vertIds.size(); i += 3 )
+					for ( std::size_t i = 0; i + 2 < face_vertIds.size(); i += 3 )
 					{
-						glm::vec3 n = glm::normalize( glm::cross(
-							positions[face_vertIds[i + 1].v] - positions[face_vertIds[i].v],
-							positions[face_vertIds[i + 2].v] - positions[face_vertIds[i].v]
-						) );
+						glm::vec3 n = TriangleNormal(
+							positions[face_vertIds[i].v],
+							positions[face_vertIds[i + 1].v],
+							positions[face_vertIds[i + 2].v]
+						);
 
 						unsigned int n_idx = static_cast<unsigned int>( normals.size() );
 						normals.push_back( n );
@@ -423,8 +679,8 @@ ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
 
 				for ( const auto& vertex : face_vertIds )
 				{
-					unsigned int& vIndex = vertexIndices[ vertex ];
-					if (vIndex == 0) // new vertex
+					auto [ vIndex, inserted ] = vertexIndices.TryEmplace( vertex, nIndexedVerts );
+					if ( inserted ) // new vertex
 					{
 						Vertex v;
 						v.position = positions[vertex.v];
@@ -432,11 +688,9 @@ ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
 						v.normal = normals[vertex.vn];
 
 						resultMesh.vertexArray.push_back(v);
-						resultMesh.indexArray.push_back(nIndexedVerts++);
-						vIndex = nIndexedVerts;	
-					} else {
-						resultMesh.indexArray.push_back(vIndex-1);
+						nIndexedVerts++;
 					}
+					resultMesh.indexArray.push_back(vIndex);
 				}
 			}break;
 		}
@@ -447,37 +701,484 @@ ObjParser::Mesh ObjParser::parse(const std::filesystem::path& fileName)
 	return resultMesh;
 }
 
-// Hash function for IndexedVert
-// version of fasthash64 https://github.com/ztanml/fast-hash
-// simplified for using only for 1 64 bit data (seed is the other one).
+//
+// Parallel parsing
+//
+// The buffer is split at line boundaries, and every chunk is tokenized on its own thread.
+// OBJ indices are global (1-based) already, so only the data that the serial path appends
+// while walking the faces needs fix-ups: the default texcoord, the computed face normals
+// (interleaved with the 'vn' records) and the deduplicated vertex indices.
+//
+
+struct ObjParser::ParsedChunk
+{
+	struct Face
+	{
+		std::uint32_t firstCorner;  // into corners
+		std::uint32_t cornerCount;
+		std::uint32_t normalSlot;   // chunk local index of its first computed normal
+		bool          needsNormalComputation;
+	};
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec3> normals;
+	std::vector<std::uint32_t> normalSlots; // chunk local index of each 'vn' record
+	std::vector<glm::vec2> texcoords;
+	std::size_t texcoordsBeforeFirstFace = 0;
+
+	std::vector<IndexedVert> corners;
+	std::vector<Face> faces;
+	std::size_t computedNormalCount = 0;
+
+	// after triangulation and chunk local deduplication
+	std::vector<IndexedVert> uniqueVerts; // in first reference order
+	std::vector<std::uint32_t> localIndices;
+	std::vector<std::uint32_t> localToGlobal;
+};
+
+// Number of triangles (so computed normals) the serial path generates for a face
+static std::uint32_t FaceTriangleCount( std::size_t cornerCount ) noexcept
+{
+	return cornerCount >= 3 ? static_cast<std::uint32_t>( cornerCount - 2 ) : 0;
+}
+
+void ObjParser::parseChunk( const char* data, std::size_t size, ParsedChunk& chunk )
+{
+	std::vector<IndexedVert> face_vertIds;
+	face_vertIds.reserve( 4 );
+
+	InMemoryTokenizer tokenizer;
+	tokenizer.SetData( data, size );
+
+	while ( tokenizer )
+	{
+		std::string_view token = tokenizer.NextToken();
+
+		if ( token.empty() ) break; // only whitespace left
+
+		if ( token[ 0 ] == '#' )
+		{
+			tokenizer.ToNextLine();
+			continue;
+		}
+
+		switch ( From2Char( token[ 0 ], token.size() > 1 ? token[ 1 ] : tokenizer.PeekChar() ) )
+		{
+			case From2Char('v',' '):
+			case From2Char('v','\t'):
+			{
+				chunk.positions.emplace_back( ReadPosition( tokenizer ) );
+			}break;
+			case From2Char('v','n'):
+			{
+				chunk.normalSlots.push_back( static_cast<std::uint32_t>( chunk.normals.size() + chunk.computedNormalCount ) );
+				chunk.normals.emplace_back( ReadNormal( tokenizer ) );
+			}break;
+			case From2Char('v','t'):
+			{
+				chunk.texcoords.emplace_back( ReadTexcoord( tokenizer ) );
+			}break;
+			case From2Char('f',' '):
+			case From2Char('f','\t'):
+			{
+				face_vertIds.clear();
+				const bool needsNormalComputation = readFaceVertices( tokenizer, face_vertIds );
+
+				if ( chunk.faces.empty() ) chunk.texcoordsBeforeFirstFace = chunk.texcoords.size();
+
+				ParsedChunk::Face face;
+				face.firstCorner = static_cast<std::uint32_t>( chunk.corners.size() );
+				face.cornerCount = static_cast<std::uint32_t>( face_vertIds.size() );
+				face.normalSlot = static_cast<std::uint32_t>( chunk.normals.size() + chunk.computedNormalCount );
+				face.needsNormalComputation = needsNormalComputation;
+				chunk.faces.push_back( face );
+				chunk.corners.insert( chunk.corners.end(), face_vertIds.cbegin(), face_vertIds.cend() );
+
+				if ( needsNormalComputation ) chunk.computedNormalCount += FaceTriangleCount( face_vertIds.size() );
+			}break;
+		}
+
+		tokenizer.ToNextLine();
+	}
+}
+
+ObjParser::Mesh ObjParser::parseParallel( const std::filesystem::path& fileName, unsigned int threadCount )
+{
+	MappedFile objFile = OpenObjFile( fileName );
+
+	return parseDataParallel( objFile.Data(), objFile.Size(), threadCount );
+}
+
+ObjParser::Mesh ObjParser::parseDataParallel( const char* data, std::size_t size, unsigned int threadCount )
+{
+	// smaller chunks are not worth the merging
+	constexpr std::size_t MIN_CHUNK_SIZE = 256 * 1024;
+
+	if ( threadCount == 0 ) threadCount = ThreadPool::Global().GetThreadCount();
+
+	const std::size_t chunkCount = std::clamp<std::size_t>( size / MIN_CHUNK_SIZE, 1, 4 * std::size_t( threadCount ) );
+	if ( chunkCount == 1 || threadCount == 1 ) return parseData( data, size );
+
+	// an explicit thread count gets its own pool of that size, so it really limits (or sets) the concurrency
+	std::optional<ThreadPool> localPool;
+	ThreadPool& pool = threadCount == ThreadPool::Global().GetThreadCount() ? ThreadPool::Global() : localPool.emplace( threadCount );
+
+	// split at line boundaries
+	std::vector<std::size_t> chunkBegin( chunkCount + 1 );
+	chunkBegin[ 0 ] = 0;
+	chunkBegin[ chunkCount ] = size;
+	for ( std::size_t c = 1; c < chunkCount; ++c )
+	{
+		std::size_t splitPos = std::max( size * c / chunkCount, chunkBegin[ c - 1 ] );
+		const void* lineEnd = std::memchr( data + splitPos, '\n', size - splitPos );
+		chunkBegin[ c ] = lineEnd ? static_cast<const char*>( lineEnd ) - data + 1 : size;
+	}
+
+	std::vector<ParsedChunk> chunks( chunkCount );
+	std::function<void( std::size_t )> task = [ & ]( std::size_t c )
+	{
+		parseChunk( data + chunkBegin[ c ], chunkBegin[ c + 1 ] - chunkBegin[ c ], chunks[ c ] );
+	};
+	pool.ParallelFor( chunkCount, task );
+
+	// global offsets of the chunk local arrays
+	std::vector<std::size_t> positionBase( chunkCount ), texcoordBase( chunkCount ), normalBase( chunkCount );
+	std::size_t positionCount = 0, texcoordCount = 0, normalCount = 0;
+	bool needsDefaultTexcoord = false;
+	bool faceSeen = false;
+	for ( std::size_t c = 0; c < chunkCount; ++c )
+	{
+		const ParsedChunk& chunk = chunks[ c ];
+
+		// the serial path inserts a (0,0) texcoord at the first face, if there was no 'vt' before it
+		if ( !faceSeen && !chunk.faces.empty() )
+		{
+			faceSeen = true;
+			needsDefaultTexcoord = ( texcoordCount + chunk.texcoordsBeforeFirstFace == 0 );
+			if ( needsDefaultTexcoord ) texcoordCount++;
+		}
+
+		positionBase[ c ] = positionCount;
+		texcoordBase[ c ] = texcoordCount;
+		normalBase[ c ] = normalCount;
+
+		positionCount += chunk.positions.size();
+		texcoordCount += chunk.texcoords.size();
+		normalCount += chunk.normals.size() + chunk.computedNormalCount;
+	}
+
+	std::vector<glm::vec3> positions( positionCount );
+	std::vector<glm::vec2> texcoords( texcoordCount );
+	std::vector<glm::vec3> normals( normalCount );
+	if ( needsDefaultTexcoord ) texcoords[ 0 ] = glm::vec2( 0.0 );
+
+	task = [ & ]( std::size_t c )
+	{
+		const ParsedChunk& chunk = chunks[ c ];
+		std::copy( chunk.positions.cbegin(), chunk.positions.cend(), positions.begin() + positionBase[ c ] );
+		std::copy( chunk.texcoords.cbegin(), chunk.texcoords.cend(), texcoords.begin() + texcoordBase[ c ] );
+		for ( std::size_t i = 0; i < chunk.normals.size(); ++i )
+		{
+			normals[ normalBase[ c ] + chunk.normalSlots[ i ] ] = chunk.normals[ i ];
+		}
+	};
+	pool.ParallelFor( chunkCount, task );
+
+	// triangulation, computed normals and chunk local deduplication
+	task = [ & ]( std::size_t c )
+	{
+		ParsedChunk& chunk = chunks[ c ];
+
+		std::vector<IndexedVert> face_vertIds;
+		VertexIndexMap vertexIndices( chunk.corners.size() / 4 );
+		chunk.localIndices.reserve( chunk.corners.size() + chunk.corners.size() / 2 );
+
+		for ( const ParsedChunk::Face& face : chunk.faces )
+		{
+			face_vertIds.assign( chunk.corners.cbegin() + face.firstCorner, chunk.corners.cbegin() + face.firstCorner + face.cornerCount );
+
+			triangulateFace( face_vertIds, positions );
+
+			if ( face.needsNormalComputation )
+			{
+				unsigned int n_idx = static_cast<unsigned int>( normalBase[ c ] + face.normalSlot );
+				for ( std::size_t i = 0; i + 2 < face_vertIds.size(); i += 3, ++n_idx )
+				{
+					normals[ n_idx ] = TriangleNormal(
+						positions[face_vertIds[i].v],
+						positions[face_vertIds[i + 1].v],
+						positions[face_vertIds[i + 2].v]
+					);
+					face_vertIds[ i ].vn = face_vertIds[ i + 1 ].vn = face_vertIds[ i + 2 ].vn = n_idx;
+				}
+			}
+
+			for ( const auto& vertex : face_vertIds )
+			{
+				auto [ localIndex, inserted ] = vertexIndices.TryEmplace( vertex, static_cast<std::uint32_t>( chunk.uniqueVerts.size() ) );
+				if ( inserted ) chunk.uniqueVerts.push_back( vertex );
+				chunk.localIndices.push_back( localIndex );
+			}
+		}
+
+		chunk.corners = std::vector<IndexedVert>();
+		chunk.faces = std::vector<ParsedChunk::Face>();
+	};
+	pool.ParallelFor( chunkCount, task );
+
+	// global deduplication: chunk order + first reference order inside the chunks gives
+	// the same vertex order as the serial path
+	std::size_t uniqueCount = 0, indexCount = 0;
+	for ( const ParsedChunk& chunk : chunks )
+	{
+		uniqueCount += chunk.uniqueVerts.size();
+		indexCount += chunk.localIndices.size();
+	}
+
+	std::vector<IndexedVert> globalVerts;
+	globalVerts.reserve( uniqueCount );
+	std::vector<std::size_t> indexBase( chunkCount );
+	{
+		VertexIndexMap vertexIndices( uniqueCount );
+
+		std::size_t indexOffset = 0;
+		for ( std::size_t c = 0; c < chunkCount; ++c )
+		{
+			ParsedChunk& chunk = chunks[ c ];
+			chunk.localToGlobal.resize( chunk.uniqueVerts.size() );
+			for ( std::size_t i = 0; i < chunk.uniqueVerts.size(); ++i )
+			{
+				auto [ globalIndex, inserted ] = vertexIndices.TryEmplace( chunk.uniqueVerts[ i ], static_cast<std::uint32_t>( globalVerts.size() ) );
+				if ( inserted ) globalVerts.push_back( chunk.uniqueVerts[ i ] );
+				chunk.localToGlobal[ i ] = globalIndex;
+			}
+
+			indexBase[ c ] = indexOffset;
+			indexOffset += chunk.localIndices.size();
+		}
+	}
+
+	Mesh resultMesh;
+	resultMesh.vertexArray.resize( globalVerts.size() );
+	resultMesh.indexArray.resize( indexCount );
+
+	task = [ & ]( std::size_t c )
+	{
+		const ParsedChunk& chunk = chunks[ c ];
+		std::transform( chunk.localIndices.cbegin(), chunk.localIndices.cend(), resultMesh.indexArray.begin() + indexBase[ c ],
+						[ &chunk ]( const std::uint32_t localIndex ) { return chunk.localToGlobal[ localIndex ]; } );
+
+		// the vertices are filled in chunkCount equal ranges
+		const std::size_t vertBegin = globalVerts.size() * c / chunkCount;
+		const std::size_t vertEnd = globalVerts.size() * ( c + 1 ) / chunkCount;
+		for ( std::size_t i = vertBegin; i < vertEnd; ++i )
+		{
+			const IndexedVert& vertex = globalVerts[ i ];
+			Vertex& v = resultMesh.vertexArray[ i ];
+			v.position = positions[vertex.v];
+			v.texcoord = texcoords[vertex.vt];
+			v.normal = normals[vertex.vn];
+		}
+	};
+	pool.ParallelFor( chunkCount, task );
+
+	return resultMesh;
+}
+
+//
+// Binary mesh cache
+//
+// <name>.obj.meshcache = MeshCacheHeader + Vertex array + index array, in native byte order.
+// Both arrays start at a MESH_CACHE_ALIGNMENT boundary of the file (zero padding before the index array).
+// MESH_CACHE_VERSION has to be increased whenever the parser (or OptimizeMesh) output or this layout changes.
+//
+
+static constexpr char          MESH_CACHE_MAGIC[ 8 ] = { 'T', 'P', 'M', 'E', 'S', 'H', '\0', '\0' };
+static constexpr std::uint32_t MESH_CACHE_VERSION = 3;
+static constexpr std::uint32_t MESH_CACHE_BYTE_ORDER = 0x01020304;
+static constexpr std::uint64_t MESH_CACHE_ALIGNMENT = 16;
 
-static inline constexpr uint64_t fasthash64_mix(uint64_t h)
+struct MeshCacheHeader
 {
-	h ^= h >> 23;
-	h *= 0x2127599bf4325c37ULL;
-	h ^= h >> 47;
-	return h;
+	char          magic[ 8 ];
+	std::uint32_t version;
+	std::uint32_t byteOrder;
+	std::uint32_t vertexSize;
+	std::uint32_t indexSize;
+	std::uint32_t isOptimized; // parseCached( ..., optimizeForGPU )
+	std::uint32_t padding;
+	std::uint64_t sourceSize;
+	std::int64_t  sourceWriteTime;
+	std::uint64_t sourceHash;
+	std::uint64_t vertexCount;
+	std::uint64_t indexCount;
+	std::uint64_t vertexOffset; // from the beginning of the file
+	std::uint64_t indexOffset;
+	std::uint64_t reserved;     // pads the header to MESH_CACHE_ALIGNMENT
+};
+static_assert( sizeof( MeshCacheHeader ) % MESH_CACHE_ALIGNMENT == 0 );
+static_assert( MESH_CACHE_ALIGNMENT % alignof( Vertex ) == 0 && MESH_CACHE_ALIGNMENT % alignof( std::uint32_t ) == 0 );
+
+static constexpr std::uint64_t AlignMeshCacheOffset( std::uint64_t offset ) noexcept
+{
+	return ( offset + MESH_CACHE_ALIGNMENT - 1 ) & ~( MESH_CACHE_ALIGNMENT - 1 );
 }
 
-static inline constexpr uint64_t fasthash64( uint64_t v, uint64_t seed )
+static std::uint64_t HashBytes( const char* data, std::size_t size ) noexcept
 {
-	constexpr uint64_t    m = 0x880355f21e6d1965ULL;
-	constexpr uint64_t    m_size = m * sizeof(uint64_t);
-	constexpr uint64_t    m_p2 = m * m;
+	std::uint64_t h = size;
+	std::size_t i = 0;
+	for ( ; i + sizeof( std::uint64_t ) <= size; i += sizeof( std::uint64_t ) )
+	{
+		std::uint64_t word;
+		std::memcpy( &word, data + i, sizeof( word ) );
+		h = fasthash64( word, h );
+	}
 
-	uint64_t h = seed ^ m_size;
-	h ^= fasthash64_mix(v);
-	h *= m_p2;
+	std::uint64_t tail = 0;
+	if ( i < size ) std::memcpy( &tail, data + i, size - i );
+	return fasthash64( tail, h );
+}
 
-	return fasthash64_mix(h);
+static std::int64_t SourceWriteTime( const std::filesystem::path& fileName ) noexcept
+{
+	std::error_code ec;
+	return std::filesystem::last_write_time( fileName, ec ).time_since_epoch().count();
 }
 
-std::size_t ObjParser::IndexedVertHash::operator()( const IndexedVert& iv ) const noexcept
+// Header check of a mapped cache file, without the source hash
+static bool IsValidMeshCache( const MappedFile& cacheFile, const MeshCacheHeader& header, std::uintmax_t sourceSize, bool isOptimized ) noexcept
 {
-	return fasthash64( iv.vt, iv.vn_64 );
+	if ( std::memcmp( header.magic, MESH_CACHE_MAGIC, sizeof( MESH_CACHE_MAGIC ) ) != 0
+		 || header.version != MESH_CACHE_VERSION
+		 || header.byteOrder != MESH_CACHE_BYTE_ORDER
+		 || header.vertexSize != sizeof( Vertex )
+		 || header.indexSize != sizeof( std::uint32_t )
+		 || header.isOptimized != std::uint32_t( isOptimized )
+		 || header.sourceSize != sourceSize )
+	{
+		return false;
+	}
+
+	const std::uint64_t fileSize = cacheFile.Size();
+	return header.vertexOffset % MESH_CACHE_ALIGNMENT == 0
+		&& header.indexOffset % MESH_CACHE_ALIGNMENT == 0
+		&& header.vertexCount <= ( fileSize - std::min<std::uint64_t>( header.vertexOffset, fileSize ) ) / sizeof( Vertex )
+		&& header.indexCount <= ( fileSize - std::min<std::uint64_t>( header.indexOffset, fileSize ) ) / sizeof( std::uint32_t );
+}
+
+static void WriteMeshCache( const std::filesystem::path& cacheFileName, const ObjParser::Mesh& mesh, MeshCacheHeader header )
+{
+	header.vertexCount = mesh.vertexArray.size();
+	header.indexCount = mesh.indexArray.size();
+	header.vertexOffset = sizeof( MeshCacheHeader );
+	header.indexOffset = AlignMeshCacheOffset( header.vertexOffset + header.vertexCount * sizeof( Vertex ) );
+
+	// written next to the final name and renamed, so a crash never leaves a truncated cache behind
+	std::filesystem::path tempFileName = cacheFileName;
+	tempFileName += ".tmp";
+
+	std::error_code ec;
+	{
+		std::ofstream cacheStrm( tempFileName, std::ios::binary | std::ios::trunc );
+		if ( !cacheStrm ) return;
+
+		cacheStrm.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+		cacheStrm.write( reinterpret_cast<const char*>( mesh.vertexArray.data() ), mesh.vertexArray.size() * sizeof( Vertex ) );
+		const char zeros[ MESH_CACHE_ALIGNMENT ] = {};
+		cacheStrm.write( zeros, static_cast<std::streamsize>( header.indexOffset - header.vertexOffset - mesh.vertexArray.size() * sizeof( Vertex ) ) );
+		cacheStrm.write( reinterpret_cast<const char*>( mesh.indexArray.data() ), mesh.indexArray.size() * sizeof( std::uint32_t ) );
+
+		if ( !cacheStrm )
+		{
+			cacheStrm.close();
+			std::filesystem::remove( tempFileName, ec );
+			return;
+		}
+	}
+
+	std::filesystem::rename( tempFileName, cacheFileName, ec );
+	if ( ec ) std::filesystem::remove( tempFileName, ec );
+}
+
+// After a hash-verified hit only the recorded write time is stale: it is patched in place (the cache may stay
+// mapped, the arrays do not change), so the next load does not hash the source again. Write errors are ignored.
+static void UpdateMeshCacheWriteTime( const std::filesystem::path& cacheFileName, std::int64_t sourceWriteTime )
+{
+	std::fstream cacheStrm( cacheFileName, std::ios::binary | std::ios::in | std::ios::out );
+	if ( !cacheStrm ) return;
+
+	cacheStrm.seekp( offsetof( MeshCacheHeader, sourceWriteTime ) );
+	cacheStrm.write( reinterpret_cast<const char*>( &sourceWriteTime ), sizeof( sourceWriteTime ) );
+}
+
+std::filesystem::path ObjParser::cachePath( const std::filesystem::path& fileName )
+{
+	std::filesystem::path cacheFileName = fileName;
+	cacheFileName += ".meshcache";
+	return cacheFileName;
+}
+
+ObjParser::CachedMesh ObjParser::parseCached( const std::filesystem::path& fileName, bool optimizeForGPU )
+{
+	std::error_code ec;
+	const std::uintmax_t sourceSize = std::filesystem::file_size( fileName, ec );
+
+	if ( ec ) throw(EXC_FILENOTFOUND);
+
+	const std::int64_t sourceWriteTime = SourceWriteTime( fileName );
+	const std::filesystem::path cacheFileName = cachePath( fileName );
+
+	CachedMesh result;
+	MappedFile sourceFile; // only mapped if the content hash is needed
+
+	if ( result.m_cacheFile.Open( cacheFileName ) && result.m_cacheFile.Size() >= sizeof( MeshCacheHeader ) )
+	{
+		const char* cacheData = result.m_cacheFile.Data();
+
+		MeshCacheHeader header;
+		std::memcpy( &header, cacheData, sizeof( header ) );
+
+		bool isValid = IsValidMeshCache( result.m_cacheFile, header, sourceSize, optimizeForGPU );
+		if ( isValid && header.sourceWriteTime != sourceWriteTime )
+		{
+			// e.g. a fresh checkout touched the file: only the content hash can tell
+			sourceFile = OpenObjFile( fileName );
+			isValid = ( HashBytes( sourceFile.Data(), sourceFile.Size() ) == header.sourceHash );
+			if ( isValid ) UpdateMeshCacheWriteTime( cacheFileName, sourceWriteTime );
+		}
+
+		if ( isValid )
+		{
+			result.m_view = MeshView<Vertex>( reinterpret_cast<const Vertex*>( cacheData + header.vertexOffset ), header.vertexCount,
+											  reinterpret_cast<const std::uint32_t*>( cacheData + header.indexOffset ), header.indexCount );
+			return result;
+		}
+	}
+	result.m_cacheFile.Close();
+
+	if ( !sourceFile.IsOpen() ) sourceFile = OpenObjFile( fileName );
+
+	result.m_mesh = parseDataParallel( sourceFile.Data(), sourceFile.Size(), 0 );
+	if ( optimizeForGPU ) OptimizeMesh( result.m_mesh );
+	result.m_view = MeshView<Vertex>( result.m_mesh );
+
+	MeshCacheHeader header = {};
+	std::memcpy( header.magic, MESH_CACHE_MAGIC, sizeof( MESH_CACHE_MAGIC ) );
+	header.version = MESH_CACHE_VERSION;
+	header.byteOrder = MESH_CACHE_BYTE_ORDER;
+	header.vertexSize = sizeof( Vertex );
+	header.indexSize = sizeof( std::uint32_t );
+	header.isOptimized = optimizeForGPU;
+	header.sourceSize = sourceSize;
+	header.sourceWriteTime = sourceWriteTime;
+	header.sourceHash = HashBytes( sourceFile.Data(), sourceFile.Size() );
+	WriteMeshCache( cacheFileName, result.m_mesh, header );
+
+	return result;
 }
 
-static std::vector<unsigned int> triangulatePolygon( const std::vector<glm::vec2>& polygon )
+std::vector<unsigned int> ObjParser::triangulatePolygon( const std::vector<glm::vec2>& polygon )
 {
 	constexpr float M_2PI = glm::two_pi<float>();
 	using Edge = std::array<unsigned int, 2>;
@@ -549,8 +1250,8 @@ static std::vector<unsigned int> triangulatePolygon( const std::vector<glm::vec2
 		glm::vec2     P = polygon[ polygonNodes[        i    ].id ];
 		glm::vec2 postP = polygon[ polygonNodes[advNode(i, 1)].id ];
 
-		float angle1 = std::atan2f( prevP.y - P.y, prevP.x - P.x );
-		float angle2 = std::atan2f( postP.y - P.y, postP.x - P.x );
+		float angle1 = std::atan2( prevP.y - P.y, prevP.x - P.x );
+		float angle2 = std::atan2( postP.y - P.y, postP.x - P.x );
 
 		polygonNodes[ i ].angle = angle1 - angle2;
 		if ( polygonNodes[ i ].angle < 0.0f )
@@ -3,11 +3,13 @@
 #include <filesystem>
 #include <fstream>
 #include <vector>
-#include <unordered_map>
 #include <functional>
 
-#include "GLUtils.hpp"
+#include "MappedFile.hpp"
+#include "MeshObject.hpp"
+#include "VertexIndexMap.hpp"
 
+class InMemoryTokenizer;
 
 class ObjParser
 {
@@ -17,39 +19,50 @@ public:
 
 	static Mesh parse(const std::filesystem::path& fileName);
 
-	enum Exception { EXC_FILENOTFOUND };
+	// Same result as parse(), but the file is split into chunks at line boundaries, which are
+	// parsed on threadCount threads (the calling thread included). threadCount == 0 means all
+	// threads of ThreadPool::Global(); any other count runs on a temporary pool of that size.
+	// Small files (under a few hundred KB) are parsed serially.
+	static Mesh parseParallel(const std::filesystem::path& fileName, unsigned int threadCount = 0);
 
-private:
-	struct IndexedVert
+	// Mesh loaded by parseCached(): either mapped from the binary cache, or freshly parsed.
+	// View() stays valid while this object lives.
+	class CachedMesh
 	{
-		union
-		{
-			struct
-			{
-				uint32_t v,vt;
-			};
-			uint64_t v_vt = 0Ul;
-		}; 
-
-		union
-		{
-			struct
-			{
-				uint32_t dummy;
-				uint32_t vn;
-			};
-			uint64_t vn_64 = 0Ul;
-		}; 
-		
-		inline bool operator==( const IndexedVert& other ) const
-		{
-			return this->v_vt == other.v_vt && this->vn == other.vn;
-		}
+	public:
+		MeshView<Vertex> View() const noexcept { return m_view; }
+		bool IsFromCache() const noexcept { return m_cacheFile.IsOpen(); }
 
-	};
+	private:
+		friend class ObjParser;
 
-	struct IndexedVertHash
-	{
-		std::size_t operator()( const IndexedVert& iv ) const noexcept;
+		MappedFile       m_cacheFile;
+		Mesh             m_mesh;
+		MeshView<Vertex> m_view;
 	};
+
+	// Maps cachePath(fileName) if it is up to date with fileName. Otherwise parses fileName
+	// (parseParallel) and writes the cache for the next load; write errors are ignored.
+	// With optimizeForGPU the mesh goes through OptimizeMesh() (see MeshOptimizer.hpp) before
+	// it is cached, so the optimization also runs only once.
+	static CachedMesh parseCached(const std::filesystem::path& fileName, bool optimizeForGPU = false);
+
+	// <fileName>.meshcache, next to the source
+	static std::filesystem::path cachePath(const std::filesystem::path& fileName);
+
+	// Triangulates a simple (CCW) polygon given by its 2D projected points.
+	// Returns indices into the polygon, 3 per triangle.
+	static std::vector<unsigned int> triangulatePolygon( const std::vector<glm::vec2>& polygon );
+
+	enum Exception { EXC_FILENOTFOUND };
+
+private:
+	struct ParsedChunk;
+
+	static Mesh parseData( const char* data, std::size_t size );
+	static Mesh parseDataParallel( const char* data, std::size_t size, unsigned int threadCount );
+	static void parseChunk( const char* data, std::size_t size, ParsedChunk& chunk );
+
+	static bool readFaceVertices( InMemoryTokenizer& tokenizer, std::vector<IndexedVert>& face_vertIds );
+	static void triangulateFace( std::vector<IndexedVert>& face_vertIds, const std::vector<glm::vec3>& positions );
 };
@@ -0,0 +1,143 @@
+#include "PoissonDisk.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// splitmix64: cellánként és körönként független, a szálak sorrendjétől nem függő véletlenszámok
+static std::uint64_t SplitMix64( std::uint64_t& state ) noexcept
+{
+	std::uint64_t z = ( state += 0x9e3779b97f4a7c15ULL );
+	z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+	z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+	return z ^ ( z >> 31 );
+}
+
+// [0, 1) egyenletesen, 24 bit pontossággal
+static float UniformFloat( std::uint64_t& state ) noexcept
+{
+	return float( SplitMix64( state ) >> 40 ) * ( 1.0f / 16777216.0f );
+}
+
+static glm::ivec3 GridSize( const glm::vec3& boxMin, const glm::vec3& boxMax, float cellSize ) noexcept
+{
+	const glm::vec3 extent = boxMax - boxMin;
+	return glm::ivec3( std::max( 1, static_cast<int>( std::ceil( extent.x / cellSize ) ) ),
+					   std::max( 1, static_cast<int>( std::ceil( extent.y / cellSize ) ) ),
+					   std::max( 1, static_cast<int>( std::ceil( extent.z / cellSize ) ) ) );
+}
+
+std::size_t PoissonDiskCellCount( const glm::vec3& boxMin, const glm::vec3& boxMax, float minDistance ) noexcept
+{
+	if ( !( minDistance > 0.0f ) ) return 0;
+
+	// a túl nagy téglatesteknél az int túlcsordulna, ezért előbb lebegőpontosan becsüljük
+	const glm::vec3 extent = glm::max( boxMax - boxMin, glm::vec3( 0.0f ) ) / ( minDistance / std::sqrt( 3.0f ) );
+	if ( double( extent.x + 1.0f ) * double( extent.y + 1.0f ) * double( extent.z + 1.0f ) > double( POISSON_DISK_MAX_CELLS ) * 8.0 )
+	{
+		return POISSON_DISK_MAX_CELLS + 1;
+	}
+
+	const glm::ivec3 size = GridSize( boxMin, boxMax, minDistance / std::sqrt( 3.0f ) );
+	return std::size_t( size.x ) * std::size_t( size.y ) * std::size_t( size.z );
+}
+
+std::vector<glm::vec3> GeneratePoissonDisk( const glm::vec3& boxMin, const glm::vec3& boxMax, const PoissonDiskSettings& settings, ThreadPool& pool )
+{
+	const std::size_t cellCount = PoissonDiskCellCount( boxMin, boxMax, settings.minDistance );
+	if ( cellCount == 0 || cellCount > POISSON_DISK_MAX_CELLS ) return {};
+
+	const float cellSize = settings.minDistance / std::sqrt( 3.0f );
+	const float minDistance2 = settings.minDistance * settings.minDistance;
+	const glm::ivec3 size = GridSize( boxMin, boxMax, cellSize );
+
+	// minden oldalon 2 üres cellával kibővítve, így a szomszédoknál nem kell a rács szélét vizsgálni
+	const glm::ivec3 padded = size + glm::ivec3( 4, 4, 4 );
+	const std::ptrdiff_t rowSize = padded.x;
+	const std::ptrdiff_t sliceSize = std::ptrdiff_t( padded.x ) * padded.y;
+	const std::size_t paddedCount = std::size_t( sliceSize ) * padded.z;
+
+	// cellánként a minta, w = 1, ha van (egy tömbben, hogy a szomszédok vizsgálata egy helyről olvasson);
+	// w = -1, ha a cellát egy szomszédos minta teljesen lefedi, így oda már nem kell dobni
+	std::vector<glm::vec4> cells( paddedCount, glm::vec4( 0.0f, 0.0f, 0.0f, 0.0f ) );
+
+	auto cellIndex = [ & ]( int x, int y, int z ) { return std::size_t( ( z + 2 ) * sliceSize + ( y + 2 ) * rowSize + ( x + 2 ) ); };
+
+	// a +-2 cellás környezet, közelebbiek előre: a legtöbb próbát egy közeli minta utasítja el
+	std::vector<std::ptrdiff_t> neighbourOffsets;
+	{
+		std::vector<std::pair<int, std::ptrdiff_t>> offsets;
+		for ( int dz = -2; dz <= 2; ++dz )
+		for ( int dy = -2; dy <= 2; ++dy )
+		for ( int dx = -2; dx <= 2; ++dx )
+		{
+			if ( dx == 0 && dy == 0 && dz == 0 ) continue;
+			offsets.emplace_back( dx * dx + dy * dy + dz * dz, dz * sliceSize + dy * rowSize + dx );
+		}
+		std::stable_sort( offsets.begin(), offsets.end(), []( const auto& a, const auto& b ) { return a.first < b.first; } );
+		for ( const auto& offset : offsets ) neighbourOffsets.push_back( offset.second );
+	}
+
+	// a (x, y, z) cellára dob egyet, ha üres; csak a +-2 cellás környezetet olvassa, ami más fázisba esik
+	auto throwDart = [ & ]( int x, int y, int z, unsigned int round )
+	{
+		const std::size_t cell = cellIndex( x, y, z );
+		if ( cells[ cell ].w != 0.0f ) return;
+
+		std::uint64_t state = settings.seed ^ ( std::uint64_t( cell ) * 0xd1b54a32d192ed03ULL ) ^ ( std::uint64_t( round ) << 58 );
+		const glm::vec3 cellMin = boxMin + glm::vec3( float( x ), float( y ), float( z ) ) * cellSize;
+		const glm::vec3 p = cellMin + glm::vec3( UniformFloat( state ), UniformFloat( state ), UniformFloat( state ) ) * cellSize;
+		if ( p.x > boxMax.x || p.y > boxMax.y || p.z > boxMax.z ) return; // a szélső cellák kilóghatnak
+
+		for ( std::ptrdiff_t offset : neighbourOffsets )
+		{
+			const glm::vec4& neighbour = cells[ std::size_t( std::ptrdiff_t( cell ) + offset ) ];
+			if ( neighbour.w <= 0.0f ) continue;
+
+			const glm::vec3 d = glm::vec3( neighbour ) - p;
+			if ( glm::dot( d, d ) <= minDistance2 )
+			{
+				// ha a cella legtávolabbi sarka is a minta gömbjében van, a cella többé nem kaphat mintát
+				const glm::vec3 toMin = glm::vec3( neighbour ) - cellMin;
+				const glm::vec3 farthest = glm::max( glm::abs( toMin ), glm::abs( toMin - cellSize ) );
+				if ( glm::dot( farthest, farthest ) <= minDistance2 ) cells[ cell ].w = -1.0f;
+				return;
+			}
+		}
+
+		cells[ cell ] = glm::vec4( p, 1.0f );
+	};
+
+	for ( unsigned int round = 0; round < settings.rounds; ++round )
+	{
+		for ( int phase = 0; phase < 27; ++phase )
+		{
+			const int px = phase % 3, py = ( phase / 3 ) % 3, pz = phase / 9;
+			if ( px >= size.x || py >= size.y || pz >= size.z ) continue;
+
+			// a fázis egy-egy z szelete egy task
+			const std::size_t sliceCount = std::size_t( ( size.z - pz + 2 ) / 3 );
+			pool.ParallelFor( sliceCount, [ & ]( std::size_t slice )
+			{
+				const int z = pz + 3 * static_cast<int>( slice );
+				for ( int y = py; y < size.y; y += 3 )
+				for ( int x = px; x < size.x; x += 3 )
+				{
+					throwDart( x, y, z, round );
+				}
+			} );
+		}
+	}
+
+	std::vector<glm::vec3> result;
+	result.reserve( static_cast<std::size_t>( std::count_if( cells.cbegin(), cells.cend(), []( const glm::vec4& c ) { return c.w > 0.0f; } ) ) );
+	for ( int z = 0; z < size.z; ++z )
+	for ( int y = 0; y < size.y; ++y )
+	for ( int x = 0; x < size.x; ++x )
+	{
+		const glm::vec4& cell = cells[ cellIndex( x, y, z ) ];
+		if ( cell.w > 0.0f ) result.push_back( glm::vec3( cell ) );
+	}
+
+	return result;
+}
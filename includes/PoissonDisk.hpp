@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool.hpp"
+
+// Párhuzamos Poisson-disk mintavételezés (dart throwing) egy téglatestben, háttérrács segítségével
+// (Wei, "Parallel Poisson Disk Sampling", SIGGRAPH 2008).
+//  - A rács cellamérete minDistance / sqrt(3), így egy cellába legfeljebb egy minta kerülhet,
+//    és egy minta szomszédai a +-2 cellás környezetben vannak.
+//  - A cellákat 27 fázisban dolgozzuk fel (a cellaindexek 3-mal vett maradéka szerint): egy fázis cellái
+//    között legalább két cella van, így párhuzamosan, zárolás nélkül dobhatnak.
+//  - Körönként minden üres cella egy próbát kap; a véletlenszámok a cellából és a körből számolódnak,
+//    így az eredmény a szálak számától független.
+// Az eredmény a cellák sorrendjében (x, majd y, majd z) jön, így az egymást követő minták közel vannak egymáshoz.
+
+// a háttérrács legfeljebb ekkora lehet (16 bájt cellánként); nagyobb téglatestre üres az eredmény
+constexpr std::size_t POISSON_DISK_MAX_CELLS = std::size_t( 1 ) << 26;
+
+struct PoissonDiskSettings
+{
+	float         minDistance = 1.0f; // a minták közötti legkisebb távolság (gömböknél az átmérő)
+	unsigned int  rounds = 16;        // ennyi próba jut legfeljebb egy cellára
+	std::uint64_t seed = 0;
+};
+
+// a cellák száma a téglatesthez (a POISSON_DISK_MAX_CELLS-szel összevetéshez, pl. a UI-ban)
+std::size_t PoissonDiskCellCount( const glm::vec3& boxMin, const glm::vec3& boxMax, float minDistance ) noexcept;
+
+std::vector<glm::vec3> GeneratePoissonDisk( const glm::vec3& boxMin, const glm::vec3& boxMax, const PoissonDiskSettings& settings,
+											ThreadPool& pool = ThreadPool::Global() );
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Rendezendő elem: 64 bites kulcs és egy hozzá tartozó érték (pl. index egy másik tömbbe)
+struct SortItem
+{
+	std::uint64_t key = 0;
+	std::uint32_t value = 0;
+};
+
+// float -> előjel nélküli egész, ugyanazzal a sorrenddel (negatívakra is), a kulcsokba csomagoláshoz
+inline std::uint32_t FloatSortKey( float value ) noexcept
+{
+	std::uint32_t bits;
+	std::memcpy( &bits, &value, sizeof( bits ) );
+	// negatívnál minden bitet, pozitívnál csak az előjelet fordítjuk
+	return bits ^ ( ( bits >> 31 ) != 0 ? 0xffffffffu : 0x80000000u );
+}
+
+// Stabil LSD radix rendezés kulcs szerint, 8 bites számjegyekkel (legfeljebb 8 menet, mindegyik O(n)).
+// A számjegyek hisztogramjai egyetlen előzetes bejárással készülnek, és azok a menetek kimaradnak, ahol
+// minden kulcsnak ugyanaz a számjegye (pl. a ritkán változó felső bitek), így a rövid kulcsok olcsók.
+// A scratch a második puffer, hívásról hívásra újrahasznosítható.
+inline void RadixSort( std::vector<SortItem>& items, std::vector<SortItem>& scratch )
+{
+	constexpr int DIGIT_COUNT = 8;
+	const std::size_t n = items.size();
+	if ( n < 2 ) return;
+
+	std::size_t histograms[ DIGIT_COUNT ][ 256 ] = {};
+	for ( const SortItem& item : items )
+	{
+		for ( int d = 0; d < DIGIT_COUNT; ++d ) ++histograms[ d ][ ( item.key >> ( 8 * d ) ) & 0xff ];
+	}
+
+	scratch.resize( n );
+	std::vector<SortItem>* source = &items;
+	std::vector<SortItem>* target = &scratch;
+	for ( int d = 0; d < DIGIT_COUNT; ++d )
+	{
+		std::size_t* histogram = histograms[ d ];
+		if ( histogram[ ( items[ 0 ].key >> ( 8 * d ) ) & 0xff ] == n ) continue; // minden kulcsnak ez a számjegye
+
+		// a számjegyenkénti darabszámokból a kezdőhelyek
+		std::size_t offset = 0;
+		for ( int b = 0; b < 256; ++b )
+		{
+			const std::size_t count = histogram[ b ];
+			histogram[ b ] = offset;
+			offset += count;
+		}
+
+		for ( const SortItem& item : *source ) ( *target )[ histogram[ ( item.key >> ( 8 * d ) ) & 0xff ]++ ] = item;
+		std::swap( source, target );
+	}
+
+	if ( source != &items ) items.swap( scratch );
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+// Egy [0, Capacity()) elemtartomány darabjainak kiosztása, pl. a GeometryArena csúcs- és index pufferében.
+// First-fit a szabad darabok offset szerint rendezett listáján; felszabadításkor a szomszédos szabad darabok
+// összeolvadnak, így a felbontás váltásakor újra és újra foglalt háló nem aprózza fel a puffert.
+// Memóriát nem foglal, csak a helyeket tartja nyilván (elemben, nem bájtban).
+class RangeAllocator
+{
+public:
+	static constexpr std::size_t INVALID = ~std::size_t( 0 );
+
+	RangeAllocator() = default;
+	explicit RangeAllocator( std::size_t capacity ) { Grow( capacity ); }
+
+	// count elem helye, vagy INVALID, ha nincs elég hosszú szabad darab (ekkor Grow, majd újra)
+	std::size_t Allocate( std::size_t count )
+	{
+		if ( count == 0 ) return 0;
+
+		for ( std::size_t i = 0; i < m_free.size(); ++i )
+		{
+			Range& range = m_free[ i ];
+			if ( range.count < count ) continue;
+
+			const std::size_t offset = range.offset;
+			range.offset += count;
+			range.count -= count;
+			if ( range.count == 0 ) m_free.erase( m_free.begin() + i );
+			m_freeCount -= count;
+			return offset;
+		}
+		return INVALID;
+	}
+
+	// egy Allocate-tel kapott darab visszaadása (ugyanazzal a count-tal)
+	void Free( std::size_t offset, std::size_t count )
+	{
+		if ( count == 0 ) return;
+
+		auto next = std::lower_bound( m_free.begin(), m_free.end(), offset, []( const Range& range, std::size_t o ) { return range.offset < o; } );
+		const bool mergePrev = next != m_free.begin() && std::prev( next )->offset + std::prev( next )->count == offset;
+		const bool mergeNext = next != m_free.end() && offset + count == next->offset;
+
+		if ( mergePrev && mergeNext )
+		{
+			std::prev( next )->count += count + next->count;
+			m_free.erase( next );
+		}
+		else if ( mergePrev )
+		{
+			std::prev( next )->count += count;
+		}
+		else if ( mergeNext )
+		{
+			next->offset = offset;
+			next->count += count;
+		}
+		else
+		{
+			m_free.insert( next, Range{ offset, count } );
+		}
+		m_freeCount += count;
+	}
+
+	// a tartomány bővítése newCapacity-re (kisebbre nem); az új rész a végén szabad
+	void Grow( std::size_t newCapacity )
+	{
+		if ( newCapacity <= m_capacity ) return;
+
+		const std::size_t oldCapacity = m_capacity;
+		m_capacity = newCapacity;
+		Free( oldCapacity, newCapacity - oldCapacity );
+	}
+
+	std::size_t Capacity() const noexcept { return m_capacity; }
+	std::size_t FreeCount() const noexcept { return m_freeCount; }
+	std::size_t FreeRangeCount() const noexcept { return m_free.size(); } // 1, ha nincs töredezettség
+
+private:
+	struct Range
+	{
+		std::size_t offset = 0;
+		std::size_t count = 0;
+	};
+
+	std::vector<Range> m_free; // a szabad darabok, offset szerint rendezve, nincs két szomszédos
+	std::size_t        m_capacity = 0;
+	std::size_t        m_freeCount = 0;
+};
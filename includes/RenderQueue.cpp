@@ -0,0 +1,66 @@
+#include "RenderQueue.hpp"
+
+std::uint64_t RenderQueue::SortKey( const DrawItem& item ) noexcept
+{
+	// a nemnegatív távolság bitjei sorrendtartók; a felső 16 bit ~1% relatív pontosság, a sorrendhez elég
+	return ( std::uint64_t( item.program & 0xffff ) << 48 ) |
+		   ( std::uint64_t( item.vao & 0xffff ) << 32 ) |
+		   ( std::uint64_t( item.texture & 0xffff ) << 16 ) |
+		   ( FloatSortKey( item.depth ) >> 16 );
+}
+
+void RenderQueue::Submit()
+{
+	m_stateChanges = 0;
+	if ( m_items.empty() ) return;
+
+	m_order.resize( m_items.size() );
+	for ( std::size_t i = 0; i < m_items.size(); ++i ) m_order[ i ] = SortItem{ SortKey( m_items[ i ] ), static_cast<std::uint32_t>( i ) };
+	RadixSort( m_order, m_scratch );
+
+	// a még nem beállított állapot: egyik név sem egyezik vele, így az első elem mindent köt
+	constexpr GLuint UNKNOWN = ~GLuint( 0 );
+	GLuint program = UNKNOWN, vao = UNKNOWN, texture = UNKNOWN, indirectBuffer = UNKNOWN;
+
+	glActiveTexture( GL_TEXTURE0 );
+	for ( const SortItem& entry : m_order )
+	{
+		const DrawItem& item = m_items[ entry.value ];
+
+		if ( item.program != program )
+		{
+			glUseProgram( program = item.program );
+			++m_stateChanges;
+		}
+		if ( item.vao != vao )
+		{
+			glBindVertexArray( vao = item.vao );
+			++m_stateChanges;
+		}
+		if ( item.texture != texture )
+		{
+			glBindTexture( GL_TEXTURE_2D, texture = item.texture );
+			++m_stateChanges;
+		}
+
+		switch ( item.kind )
+		{
+		case DrawItem::Kind::ElementsIndirect:
+			if ( item.indirectBuffer != indirectBuffer )
+			{
+				glBindBuffer( GL_DRAW_INDIRECT_BUFFER, indirectBuffer = item.indirectBuffer );
+				++m_stateChanges;
+			}
+			glMultiDrawElementsIndirect( item.mode, item.indexType, reinterpret_cast<const void*>( item.indirectOffset ), item.count, 0 );
+			break;
+		case DrawItem::Kind::Arrays:
+			glDrawArrays( item.mode, item.first, item.count );
+			break;
+		}
+	}
+
+	if ( indirectBuffer != UNKNOWN ) glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+	glBindVertexArray( 0 );
+	glUseProgram( 0 );
+}
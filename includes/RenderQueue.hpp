@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "RadixSort.hpp"
+
+// Egy rajzolási hívás és a hozzá szükséges állapot. A program uniformjai nem részei: azok a programban
+// megmaradnak, így elég változáskor beállítani őket, nem rajzolásonként.
+struct DrawItem
+{
+	enum class Kind : std::uint8_t
+	{
+		ElementsIndirect, // glMultiDrawElementsIndirect a kötött indirectBuffer-ből
+		Arrays,			  // glDrawArrays, attribútum nélküli rajzoláshoz
+	};
+
+	GLuint program = 0;
+	GLuint vao = 0;
+	GLuint texture = 0;		   // GL_TEXTURE_2D a 0. textúraegységen
+	GLuint indirectBuffer = 0; // GL_DRAW_INDIRECT_BUFFER (ElementsIndirect)
+	float  depth = 0.0f;	   // a kamerától mért távolság: azonos állapotú elemek közül a közelebbi megy előre (early-Z)
+
+	Kind     kind = Kind::ElementsIndirect;
+	GLenum   mode = GL_TRIANGLES;
+	GLenum   indexType = GL_UNSIGNED_INT; // ElementsIndirect
+	GLintptr indirectOffset = 0;		  // ElementsIndirect: az első parancs helye bájtban
+	GLint    first = 0;					  // Arrays: az első csúcs
+	GLsizei  count = 0;					  // ElementsIndirect: a parancsok, Arrays: a csúcsok száma
+};
+
+// Képkockánként összegyűjtött rajzolások. A Submit (program, VAO, textúra, mélység) kulcs szerint
+// radix rendezéssel sorba teszi őket, és csak azt az állapotot köti újra, ami az előző elemhez képest változott.
+class RenderQueue
+{
+public:
+	void Clear() noexcept { m_items.clear(); }
+	void Push( const DrawItem& item ) { m_items.push_back( item ); }
+
+	// Rendezés és kirajzolás; a végén a programot, a VAO-t, a textúrát és az indirect puffert leköti.
+	// A hívás előtti kötéseket nem tételezi fel, az első elem mindent beállít.
+	void Submit();
+
+	std::size_t ItemCount() const noexcept { return m_items.size(); }
+	std::size_t StateChangeCount() const noexcept { return m_stateChanges; } // az utolsó Submit-ban
+
+	// Program, VAO, textúra (a nevek alsó 16 bitje), majd a mélység felső 16 bitje. Ha két név alsó bitjei
+	// egyeznek, csak a csoportosítás romlik: a Submit a valódi neveket hasonlítja.
+	static std::uint64_t SortKey( const DrawItem& item ) noexcept;
+
+private:
+	std::vector<DrawItem> m_items;
+	std::vector<SortItem> m_order;
+	std::vector<SortItem> m_scratch;
+	std::size_t           m_stateChanges = 0;
+};
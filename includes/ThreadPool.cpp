@@ -0,0 +1,120 @@
+#include "ThreadPool.hpp"
+
+// a pool szálain (és a ParallelFor-t futtató hívón) igaz: így az egymásba ágyazott hívás nem akad meg
+static thread_local bool t_insidePool = false;
+
+ThreadPool::ThreadPool( unsigned int threadCount )
+{
+	// a hívó szál is dolgozik, ezért eggyel kevesebb háttérszál kell
+	for ( unsigned int i = 1; i < threadCount; ++i )
+	{
+		m_workers.emplace_back( &ThreadPool::WorkerLoop, this );
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_quit = true;
+	}
+	m_wakeCondition.notify_all();
+
+	for ( std::thread& worker : m_workers )
+	{
+		worker.join();
+	}
+}
+
+ThreadPool& ThreadPool::Global()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::ParallelFor( std::size_t taskCount, const std::function<void( std::size_t )>& func )
+{
+	if ( taskCount == 0 ) return;
+
+	if ( t_insidePool || m_workers.empty() || taskCount == 1 )
+	{
+		for ( std::size_t task = 0; task < taskCount; ++task )
+		{
+			func( task );
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> jobLock( m_jobMutex );
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_func = &func;
+		m_taskCount = taskCount;
+		m_nextTask = 0;
+		m_finishedTasks = 0;
+		m_exception = nullptr;
+		++m_generation;
+	}
+	m_wakeCondition.notify_all();
+
+	t_insidePool = true;
+	RunTasks();
+	t_insidePool = false;
+
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock( m_mutex );
+		m_doneCondition.wait( lock, [ this ]() { return m_finishedTasks == m_taskCount; } );
+		m_func = nullptr;
+		exception = m_exception;
+	}
+
+	if ( exception ) std::rethrow_exception( exception );
+}
+
+void ThreadPool::WorkerLoop()
+{
+	t_insidePool = true;
+
+	std::size_t seenGeneration = 0;
+	for ( ;; )
+	{
+		{
+			std::unique_lock<std::mutex> lock( m_mutex );
+			m_wakeCondition.wait( lock, [ & ]() { return m_quit || m_generation != seenGeneration; } );
+			if ( m_quit ) return;
+			seenGeneration = m_generation;
+		}
+
+		RunTasks();
+	}
+}
+
+void ThreadPool::RunTasks()
+{
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( m_func != nullptr && m_nextTask < m_taskCount )
+	{
+		const std::size_t task = m_nextTask++;
+		const std::function<void( std::size_t )>* func = m_func;
+		lock.unlock();
+
+		try
+		{
+			( *func )( task );
+		}
+		catch ( ... )
+		{
+			lock.lock();
+			if ( !m_exception ) m_exception = std::current_exception();
+			lock.unlock();
+		}
+
+		lock.lock();
+		if ( ++m_finishedTasks == m_taskCount )
+		{
+			m_doneCondition.notify_all();
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Egyszerű, állandó szálakból álló pool a CPU oldali előfeldolgozáshoz (OBJ betöltés, mesh generálás).
+// Egyszerre egy ParallelFor fut; a hívó szál is dolgozik, és csak akkor tér vissza, ha minden task kész.
+class ThreadPool
+{
+public:
+	explicit ThreadPool( unsigned int threadCount = std::thread::hardware_concurrency() );
+	~ThreadPool();
+
+	ThreadPool( const ThreadPool& ) = delete;
+	ThreadPool& operator=( const ThreadPool& ) = delete;
+
+	// a program közös példánya, hardware_concurrency() szállal
+	static ThreadPool& Global();
+
+	// a hívó szállal együtt ennyi szál dolgozhat egy ParallelFor-on
+	unsigned int GetThreadCount() const noexcept { return static_cast<unsigned int>( m_workers.size() ) + 1; }
+
+	// func( taskIndex ) meghívása minden taskIndex in [0, taskCount) értékre.
+	// Pool szálról hívva (egymásba ágyazva) sorosan fut le. Az első kivételt a hívó szálon dobja tovább.
+	void ParallelFor( std::size_t taskCount, const std::function<void( std::size_t )>& func );
+
+private:
+	void WorkerLoop();
+	void RunTasks();
+
+	std::vector<std::thread> m_workers;
+
+	std::mutex              m_jobMutex; // egyszerre egy ParallelFor
+	std::mutex              m_mutex;
+	std::condition_variable m_wakeCondition;
+	std::condition_variable m_doneCondition;
+
+	const std::function<void( std::size_t )>* m_func = nullptr;
+	std::size_t        m_taskCount = 0;
+	std::size_t        m_nextTask = 0;
+	std::size_t        m_finishedTasks = 0;
+	std::size_t        m_generation = 0;
+	std::exception_ptr m_exception;
+	bool               m_quit = false;
+};
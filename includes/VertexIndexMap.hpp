@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// fasthash64 https://github.com/ztanml/fast-hash
+// egyszerűsítve egyetlen 64 bites adatra (a seed a másik).
+
+inline constexpr std::uint64_t fasthash64_mix( std::uint64_t h )
+{
+	h ^= h >> 23;
+	h *= 0x2127599bf4325c37ULL;
+	h ^= h >> 47;
+	return h;
+}
+
+inline constexpr std::uint64_t fasthash64( std::uint64_t v, std::uint64_t seed )
+{
+	constexpr std::uint64_t m = 0x880355f21e6d1965ULL;
+	constexpr std::uint64_t m_size = m * sizeof( std::uint64_t );
+	constexpr std::uint64_t m_p2 = m * m;
+
+	std::uint64_t h = seed ^ m_size;
+	h ^= fasthash64_mix( v );
+	h *= m_p2;
+
+	return fasthash64_mix( h );
+}
+
+// Egy OBJ lap csúcsa: 0-tól számozott pozíció, textúrakoordináta és normális index (96 bit)
+struct IndexedVert
+{
+	std::uint32_t v = 0;
+	std::uint32_t vt = 0;
+	std::uint32_t vn = 0;
+
+	bool operator==( const IndexedVert& other ) const noexcept
+	{
+		return v == other.v && vt == other.vt && vn == other.vn;
+	}
+};
+
+struct IndexedVertHash
+{
+	std::size_t operator()( const IndexedVert& iv ) const noexcept
+	{
+		return static_cast<std::size_t>( fasthash64( ( std::uint64_t( iv.vt ) << 32 ) | iv.v, iv.vn ) );
+	}
+};
+
+// IndexedVert -> csúcsindex hasítótábla a csúcsok összevonásához.
+// Nyílt címzés, lineáris próbálás: a kulcs és az érték egy 16 bájtos slotban van, a tábla egyetlen
+// tömb, így beszúráskor nincs csúcsonkénti allokáció. Törölni nem lehet, csak az egészet üríteni.
+class VertexIndexMap
+{
+public:
+	VertexIndexMap() = default;
+	explicit VertexIndexMap( std::size_t expectedCount ) { Reserve( expectedCount ); }
+
+	// legalább expectedCount elem fér el újrahasítás nélkül
+	void Reserve( std::size_t expectedCount )
+	{
+		std::size_t capacity = MIN_CAPACITY;
+		while ( capacity * MAX_LOAD_NUM < expectedCount * MAX_LOAD_DEN ) capacity *= 2;
+		if ( capacity > m_slots.size() ) Rehash( capacity );
+	}
+
+	// Ha a kulcs még nincs benne, value-val beszúrja. Visszaadja a tárolt értéket, és hogy új-e.
+	// value != EMPTY (az üres slot jelölése).
+	std::pair<std::uint32_t, bool> TryEmplace( const IndexedVert& key, std::uint32_t value )
+	{
+		if ( ( m_size + 1 ) * MAX_LOAD_DEN > m_slots.size() * MAX_LOAD_NUM ) Rehash( m_slots.empty() ? MIN_CAPACITY : m_slots.size() * 2 );
+
+		const std::size_t mask = m_slots.size() - 1;
+		for ( std::size_t i = IndexedVertHash()( key ) & mask; ; i = ( i + 1 ) & mask )
+		{
+			Slot& slot = m_slots[ i ];
+			if ( slot.value == EMPTY )
+			{
+				slot.key = key;
+				slot.value = value;
+				++m_size;
+				return { value, true };
+			}
+			if ( slot.key == key ) return { slot.value, false };
+		}
+	}
+
+	// a kulcshoz tárolt érték, vagy EMPTY, ha nincs benne
+	std::uint32_t Find( const IndexedVert& key ) const noexcept
+	{
+		if ( m_slots.empty() ) return EMPTY;
+
+		const std::size_t mask = m_slots.size() - 1;
+		for ( std::size_t i = IndexedVertHash()( key ) & mask; ; i = ( i + 1 ) & mask )
+		{
+			const Slot& slot = m_slots[ i ];
+			if ( slot.value == EMPTY ) return EMPTY;
+			if ( slot.key == key ) return slot.value;
+		}
+	}
+
+	std::size_t Size() const noexcept { return m_size; }
+
+	void Clear() noexcept
+	{
+		for ( Slot& slot : m_slots ) slot.value = EMPTY;
+		m_size = 0;
+	}
+
+	static constexpr std::uint32_t EMPTY = ~std::uint32_t( 0 );
+
+private:
+	struct Slot
+	{
+		IndexedVert   key;
+		std::uint32_t value = EMPTY;
+	};
+	static_assert( sizeof( Slot ) == 16 );
+
+	// legfeljebb 1/2-ig töltjük: lineáris próbálásnál e fölött gyorsan nőnek a láncok
+	static constexpr std::size_t MAX_LOAD_NUM = 1;
+	static constexpr std::size_t MAX_LOAD_DEN = 2;
+	static constexpr std::size_t MIN_CAPACITY = 16;
+
+	void Rehash( std::size_t capacity )
+	{
+		std::vector<Slot> oldSlots( capacity );
+		oldSlots.swap( m_slots );
+
+		const std::size_t mask = capacity - 1;
+		for ( const Slot& slot : oldSlots )
+		{
+			if ( slot.value == EMPTY ) continue;
+
+			std::size_t i = IndexedVertHash()( slot.key ) & mask;
+			while ( m_slots[ i ].value != EMPTY ) i = ( i + 1 ) & mask;
+			m_slots[ i ] = slot;
+		}
+	}
+
+	std::vector<Slot> m_slots; // mérete 2 hatvány (vagy 0)
+	std::size_t       m_size = 0;
+};